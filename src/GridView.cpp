@@ -1,18 +1,23 @@
 #include "GridView.h"
 
 #include <stdio.h>
-#include <stdlib.h>	// srandom
+#include <string.h>	// strcmp
 
 #include <Alert.h>
+#include <Directory.h>
 #include <MenuBar.h>
 #include <MenuItem.h>
+#include <OS.h>
 #include <Path.h>
 #include <Roster.h>
+#include <String.h>
 #include <TranslationUtils.h>
 #include <TranslatorFormats.h>
 
 #include "AboutWindow.h"
+#include "PackCatalogue.h"
 #include "Preferences.h"
+#include "PuzzleGenerator.h"
 
 enum
 {
@@ -23,7 +28,8 @@ enum
 	M_CHOOSE_LEVEL,
 	M_SOUND_ON,
 	M_SOUND_OFF,
-	M_SHOW_MANUAL
+	M_SHOW_MANUAL,
+	M_SHOW_HINT
 };
 
 static PuzzlePackSet gPuzzles;
@@ -33,6 +39,8 @@ static const int8 minDimension = 3;
 static const int8 maxDimension = 8;
 static const int8 defaultDimension = 5;
 static const int8 maxNumButtons = maxDimension * maxDimension;
+// the session logs kept, this run's included
+static const int32 maxSessions = 50;
 
 /*
  * Maximum levels (number of moves required) for dimensions 3x3 through 8x8
@@ -40,11 +48,22 @@ static const int8 maxNumButtons = maxDimension * maxDimension;
  * Note: although the nullity of 3x3 and 6x6 through 8x8 dimensions is 0, which
  * means the maximum level is n*n where n = 3, 6, 7, or 8, I set them to 1 less
  * because otherwise, the solutions would be simply pressing all buttons. --Owen
+ *
+ * The 4x4 and 5x5 maximums are the hardest boards there are, as counted by
+ * tools/StateSpaceEnumerator. Up to 5x5, Grid::Random() draws each puzzle
+ * evenly from all boards of its level, through PuzzleGenerator.
  */
 static const int8 maxLevels[] = { 8, 7, 15, 35, 48, 63 };
 
 static int8 lastLevels[maxDimension - minDimension + 1];
 
+static bool
+IsPlayable(PuzzlePack* pack)
+{
+	return pack->Dimension() >= minDimension
+		&& pack->Dimension() <= maxDimension;
+}
+
 static void
 LoadSoundFile(BFileGameSound*& sound, const char* file)
 {
@@ -73,14 +92,37 @@ LoadSoundFile(BFileGameSound*& sound, const char* file)
 	sound = NULL;
 }
 
+/*
+ * Build the puzzle generators, 5x5 taking a second or so, on a thread of
+ * their own rather than on the window's when the first puzzle is drawn.
+ */
+
+static int32
+BuildGenerators(void*)
+{
+	PuzzleGenerator::ForDimension(defaultDimension);
+	for (int8 dimension = minDimension; dimension <= maxDimension; dimension++)
+		PuzzleGenerator::ForDimension(dimension);
+
+	return 0;
+}
+
 GridView::GridView()
 	:
 	BView(BRect(0, 0, 260, 280), "gridview", B_FOLLOW_ALL, B_WILL_DRAW),
 	fPuzzle(NULL),
+	fMovesRequired(-1),
 	fClickSound(NULL),
 	fWinSound(NULL),
 	fNoWinSound(NULL)
 {
+	// the first random puzzle is drawn as soon as the window shows; the
+	// first run writes the 5x5 database that later ones map
+	create_directory(DISTANCES_PATH, 0755);
+	PuzzleGenerator::SetDatabaseDirectory(DISTANCES_PATH);
+	resume_thread(spawn_thread(BuildGenerators, "puzzle generators",
+		B_NORMAL_PRIORITY, NULL));
+
 	SetViewColor(0,0,50);
 	
 	BRect r(0,0,Bounds().Width(),20);
@@ -91,6 +133,7 @@ GridView::GridView()
 	bar->AddItem(fMenu);
 	
 	fMenu->AddItem(new BMenuItem("Restart level",new BMessage(M_RESET_LEVEL),'R'));
+	fMenu->AddItem(new BMenuItem("Show hint", new BMessage(M_SHOW_HINT), 'H'));
 	fMenu->AddSeparatorItem();
 	
 	fSoundMenu = new BMenu("Sound");
@@ -111,11 +154,20 @@ GridView::GridView()
 
 	RandomMenu();
 
-	for (int8 i = 0; i < gPuzzles.CountPacks(); i++) {
+	// only the headers of the packs in the packs folder are read here, and
+	// mostly not even those; a pack is mapped when it is chosen
+	PackCatalogue catalogue;
+	catalogue.LoadIndex(PACK_INDEX_PATH);
+	if (catalogue.Scan(PACKS_PATH, gPuzzles) == B_OK && catalogue.IsModified())
+		catalogue.SaveIndex(PACK_INDEX_PATH);
+
+	for (int32 i = 0; i < gPuzzles.CountPacks(); i++) {
 		PuzzlePack *pack = gPuzzles.PackAt(i);
-		
+		if (!IsPlayable(pack))
+			continue;
+
 		BMessage *msg = new BMessage(M_CHOOSE_PACK);
-		msg->AddInt8("index", i);
+		msg->AddInt32("index", i);
 		fPackMenu->AddItem(new BMenuItem(pack->Name(),msg));
 	}
 
@@ -127,7 +179,16 @@ GridView::GridView()
 	fSoundMenu->ItemAt(!fUseSound)->SetMarked(true);
 
 	fGrid = new Grid(fDimension);
-	srandom(system_time());
+	fRandom.Seed(system_time());
+
+	// one log per run, named after the time it started, and only the last
+	// few runs' are kept
+	BString sessionPath;
+	sessionPath.SetToFormat("%s/%" B_PRId64, SESSIONS_PATH,
+		real_time_clock_usecs());
+	create_directory(SESSIONS_PATH, 0755);
+	PruneSessionLogs(SESSIONS_PATH, maxSessions - 1);
+	fRecorder.Open(sessionPath.String());
 
 	fButtons = new TwoStateDrawButton*[maxNumButtons];
 
@@ -172,6 +233,7 @@ GridView::GridView()
 GridView::~GridView()
 {
 	ShutdownPreferences();
+	fRecorder.Close();
 
 	delete fClickSound;
 	delete fWinSound;
@@ -210,22 +272,13 @@ void GridView::MessageReceived(BMessage *msg)
 	const int8 index = msg->what - 1000;
 
 	if (index >= 0 && index < fDimension * fDimension) {
-		bool isUndo;
-
-		if (fCurrentCount > 0 && index == fMoves[fCurrentCount - 1]) {
-			fCurrentCount--;
-			isUndo = true;
-		} else {
-			if (fCurrentCount < fMoves.size())
-				fMoves[fCurrentCount] = index;
-			else
-				fMoves.push_back(index);
-
-			fCurrentCount++;
-			isUndo = false;
-		}
+		fRecorder.AddPress(system_time(), index);
+
+		// pressing the last button again takes it back
+		const bool isUndo = fHistory.PressOrUndo(index);
+		fHints.Press(index);
 
-		SetMovesLabel(fCurrentCount);
+		SetMovesLabel(fHistory.Position());
 		PressButton(index);
 
 		if (fUseSound && fClickSound != NULL)
@@ -233,10 +286,6 @@ void GridView::MessageReceived(BMessage *msg)
 
 		if (!isUndo && fGrid->GetGridValues() == 0)
 			HandleFinish();
-		else {
-			fMoveCount = fCurrentCount;
-			fGridValues = 0;
-		}
 
 		return;
 	}
@@ -276,6 +325,11 @@ void GridView::MessageReceived(BMessage *msg)
 			SetLevel(fLevel);
 			break;
 		}
+		case M_SHOW_HINT:
+		{
+			ShowHint();
+			break;
+		}
 		case B_ABOUT_REQUESTED:
 		{
 			AboutWindow *abwin = new AboutWindow();
@@ -295,17 +349,18 @@ void GridView::MessageReceived(BMessage *msg)
 		}
 		case M_CHOOSE_PACK:
 		{
-			int8 index;
-			if (msg->FindInt8("index", &index) == B_OK) {
-				UpdateDimension(defaultDimension);
-				SetPack(gPuzzles.PackAt(index));
+			int32 index;
+			if (msg->FindInt32("index", &index) == B_OK) {
+				PuzzlePack* pack = gPuzzles.PackAt(index);
+				UpdateDimension(pack->Dimension());
+				SetPack(pack);
 			}
 			break;
 		}
 		case M_CHOOSE_LEVEL:
 		{
-			int8 level;
-			if (msg->FindInt8("level", &level) == B_OK)
+			int32 level;
+			if (msg->FindInt32("level", &level) == B_OK)
 				SetLevel(level);
 			break;
 		}
@@ -334,6 +389,12 @@ void GridView::KeyDown(const char* bytes, int32 numBytes)
 		case B_END:
 			Restore();
 			break;
+		case B_UP_ARROW:
+			SwitchBranch(false);
+			break;
+		case B_DOWN_ARROW:
+			SwitchBranch(true);
+			break;
 		default:
 			BView::KeyDown(bytes, numBytes);
 			return;
@@ -342,47 +403,85 @@ void GridView::KeyDown(const char* bytes, int32 numBytes)
 
 void GridView::Restart()
 {
-	if (fCurrentCount > 0) {
-		fCurrentCount = 0;
-		SetMovesLabel(0);
-
-		if (fGridValues == 0)
-			fGridValues = fGrid->GetGridValues();
+	fRecorder.AddEvent(system_time(), kRestartEvent);
 
-		fGrid->SetGridValues(fPuzzleValues);
-		UpdateButtons();
+	if (fHistory.Position() > fHistory.First()) {
+		fHistory.Seek(fHistory.First());
+		fHints.SetBoard(fHistory.Board());
+		SetMovesLabel(fHistory.Position());
+		ShowBoard(fHistory.Board());
 	}
 }
 
 void GridView::Undo()
 {
-	if (fCurrentCount > 0) {
-		fCurrentCount--;
-		SetMovesLabel(fCurrentCount);
+	fRecorder.AddEvent(system_time(), kUndoEvent);
 
-		if (fGridValues == 0)
-			fGridValues = fGrid->GetGridValues();
-
-		PressButton(fMoves[fCurrentCount]);
+	if (fHistory.Undo()) {
+		fHints.Press(fHistory.MoveAt(fHistory.Position()));
+		SetMovesLabel(fHistory.Position());
+		ShowBoard(fHistory.Board());
 	}
 }
 
 void GridView::Redo()
 {
-	if (fCurrentCount < fMoveCount) {
-		PressButton(fMoves[fCurrentCount]);
-		fCurrentCount++;
-		SetMovesLabel(fCurrentCount);
+	fRecorder.AddEvent(system_time(), kRedoEvent);
+
+	if (fHistory.Redo()) {
+		fHints.Press(fHistory.MoveAt(fHistory.Position() - 1));
+		SetMovesLabel(fHistory.Position());
+		ShowBoard(fHistory.Board());
 	}
 }
 
 void GridView::Restore()
 {
-	if (fCurrentCount < fMoveCount) {
-		fCurrentCount = fMoveCount;
-		SetMovesLabel(fMoveCount);
-		fGrid->SetGridValues(fGridValues);
-		UpdateButtons();
+	fRecorder.AddEvent(system_time(), kRestoreEvent);
+
+	if (fHistory.Position() < fHistory.Length()) {
+		fHistory.Seek(fHistory.Length());
+		fHints.SetBoard(fHistory.Board());
+		SetMovesLabel(fHistory.Position());
+		ShowBoard(fHistory.Board());
+	}
+}
+
+/*
+ * Pick which of the moves tried from here Redo() and Restore() follow.
+ */
+
+void GridView::SwitchBranch(bool next)
+{
+	if (next) {
+		fRecorder.AddEvent(system_time(), kNextBranchEvent);
+		fHistory.NextBranch();
+	} else {
+		fRecorder.AddEvent(system_time(), kPreviousBranchEvent);
+		fHistory.PreviousBranch();
+	}
+}
+
+/*
+ * Blink a button that is part of the fewest presses that solve the grid
+ * from here.
+ */
+
+void GridView::ShowHint()
+{
+	const int8 button = fHints.NextPress();
+	if (button < 0)
+		return;
+
+	const bool isOn = fGrid->ValueAt(button);
+	for (int8 i = 0; i < 3; i++) {
+		fButtons[button]->SetState(!isOn);
+		Window()->UpdateIfNeeded();
+		snooze((bigtime_t) 1.5e5);
+
+		fButtons[button]->SetState(isOn);
+		Window()->UpdateIfNeeded();
+		snooze((bigtime_t) 1.5e5);
 	}
 }
 
@@ -416,47 +515,37 @@ void GridView::RandomMenu()
 
 void GridView::PressButton(int8 index)
 {
-	FlipButton(index);
-
-	const int8 n = fDimension;	// n by n grid
-
-	if (index % n)	// not leftmost column
-		FlipButton(index - 1);	// left neighbor
+	uint64 toggled = fGrid->Press(index);
 
-	if ((index + 1) % n)	// not rightmost column
-		FlipButton(index + 1);	// right neighbor
-
-	if (index >= n)	// not top row
-		FlipButton(index - n);	// neighbor above
-
-	if (index < n * (n - 1))	// not bottom row
-		FlipButton(index + n);	// neighbor below
+	for (int8 offset = 0; toggled != 0; offset++, toggled >>= 1)
+		if (toggled & 1)
+			fButtons[offset]->SetState(fGrid->ValueAt(offset));
 }
 
-void GridView::FlipButton(int8 offset)
+/*
+ * Put values on the grid, updating only the buttons that change.
+ */
+
+void GridView::ShowBoard(uint64 values)
 {
-	if(fButtons[offset]->GetState())
-	{
-		fButtons[offset]->SetState(0);
-		fGrid->SetValue(offset, false);
-	}
-	else
-	{
-		fButtons[offset]->SetState(1);
-		fGrid->SetValue(offset, true);
-	}
+	uint64 toggled = fGrid->GetGridValues() ^ values;
+	fGrid->SetGridValues(values);
+
+	for (int8 offset = 0; toggled != 0; offset++, toggled >>= 1)
+		if (toggled & 1)
+			fButtons[offset]->SetState(fGrid->ValueAt(offset));
 }
 
 void GridView::SetRandom(int8 dimension)
 {
 	fPuzzle = NULL;
 
-	for (int8 index = fLevelMenu->CountItems() - 1; index >= 0; index--)
+	for (int32 index = fLevelMenu->CountItems() - 1; index >= 0; index--)
 		delete fLevelMenu->RemoveItem(index);
 
 	for (int8 index = 0; index < maxLevels[dimension - minDimension]; index++) {
 		BMessage* msg = new BMessage(M_CHOOSE_LEVEL);
-		msg->AddInt8("level", index);
+		msg->AddInt32("level", index);
 
 		char levelname[16];
 		sprintf(levelname, "Level %d", index + 1);
@@ -512,19 +601,28 @@ void GridView::UpdateGrid(BRect rect, int8 oldDimension)
 
 void GridView::SetPack(PuzzlePack *pack)
 {
+	if (pack->Load() != B_OK) {
+		BString msg("The puzzle pack \"");
+		msg << pack->Name() << "\" could not be opened.";
+		BAlert *alert = new BAlert("Lights Off", msg.String(), "OK");
+		alert->Go();
+		SetRandom(fDimension);
+		return;
+	}
+
 	fPuzzle = pack;
 	
-	for(int8 i = fLevelMenu->CountItems() - 1; i >= 0; i--) {
+	for(int32 i = fLevelMenu->CountItems() - 1; i >= 0; i--) {
 		BMenuItem *old = fLevelMenu->RemoveItem(i);
 		delete old;
 	}
 	
-	for (int8 index = 0; index < fPuzzle->Size(); index++) {
+	for (uint32 index = 0; index < fPuzzle->Size(); index++) {
 		BMessage *msg = new BMessage(M_CHOOSE_LEVEL);
-		msg->AddInt8("level", index);
+		msg->AddInt32("level", index);
 		
 		char levelname[30];
-		sprintf(levelname, "Level %d", index + 1);
+		sprintf(levelname, "Level %d", (int) index + 1);
 		
 		BMenuItem *item = new BMenuItem(levelname,msg);
 		fLevelMenu->AddItem(item);
@@ -534,7 +632,7 @@ void GridView::SetPack(PuzzlePack *pack)
 
 	fLevelMenu->SetTargetForItems(this);
 
-	for(int8 i = 0; i < fPackMenu->CountItems(); i++) {
+	for(int32 i = 0; i < fPackMenu->CountItems(); i++) {
 		BMenuItem *packitem = fPackMenu->ItemAt(i);
 		if(strcmp(packitem->Label(),pack->Name())==0)
 		{
@@ -546,15 +644,14 @@ void GridView::SetPack(PuzzlePack *pack)
 	SetLevel(fPuzzle->Highest());
 }
 
-void GridView::SetLevel(int8 level)
+void GridView::SetLevel(int32 level)
 {
 	fLevel = level;
-	fMoveCount = fCurrentCount = 0;
-	SetMovesLabel(0);
 
-	const int8 numMoves = level + 1;
+	const int32 numMoves = level + 1;
+	uint32 seed = 0;
 
-	char label[16];
+	char label[32];
 	sprintf(label, "Level: %d", numMoves);
 	fLevelLabel->SetText(label);
 	fLevelLabel->ResizeToPreferred();
@@ -568,6 +665,8 @@ void GridView::SetLevel(int8 level)
 		snooze((bigtime_t) 2e5);
 	}
 
+	fGrid->SetRules(fPuzzle != NULL ? fPuzzle->GetRules() : Rules());
+
 	if (fPuzzle) {
 		fGrid->SetGridValues(fPuzzle->ValueAt(level));
 
@@ -583,18 +682,41 @@ void GridView::SetLevel(int8 level)
 	} else {
 		if (!isHidden)
 			for (int8 i = 0; i < 4; i++) {
-				fGrid->Random(fDimension);
+				fGrid->Random(fDimension, fRandom);
 				UpdateButtons();
 				Window()->UpdateIfNeeded();
 				snooze((bigtime_t) 1e5);
 			}
 
+		// a generator of its own, so that the session log can make up the
+		// same puzzle from its seed
 		lastLevels[fDimension - minDimension] = level;
-		fGrid->Random(numMoves);
+		seed = fRandom.Next();
+		RandomGenerator generator(seed);
+		fGrid->Random(numMoves, generator);
 		UpdateButtons();
 	}
 
-	fPuzzleValues = fGrid->GetGridValues();
+	fHistory.Start(*fGrid);
+	fHints.Start(*fGrid);
+
+	// the distance database of a new dimension, or one the generators have
+	// only just written
+	if (fDistances.Dimension() != fDimension) {
+		fDistances.Open(DistanceDatabase::Path(DISTANCES_PATH,
+			fDimension).c_str());
+	}
+
+	SetMovesLabel(0);
+
+	// the hints already know the optimum, for packs that don't store it;
+	// the pack works it out itself if they don't, and a count it stores
+	// always wins
+	fMovesRequired = fPuzzle != NULL
+		? fPuzzle->MovesRequired(level, fHints.MovesRemaining()) : -1;
+	fRecorder.StartPuzzle(system_time(), fDimension,
+		fPuzzle != NULL ? fPuzzle->Name() : NULL, level, seed,
+		fGrid->GetGridValues());
 
 	BMenuItem *current = fLevelMenu->ItemAt(level);
 	current->SetMarked(true);
@@ -606,15 +728,39 @@ void GridView::UpdateButtons()
 		fButtons[index]->SetState(fGrid->ValueAt(index));
 }
 
-void GridView::SetMovesLabel(int8 count)
+/*
+ * Show the moves made so far and the fewest that are left, if the board can
+ * still be solved, keeping the label against the right edge of the view.
+ */
+
+void GridView::SetMovesLabel(int32 count)
 {
+	// the distance database knows every classic board of its size, and the
+	// hints cover the rest
+	int32 remaining = fHints.MovesRemaining();
+	if (fDistances.Dimension() == fDimension && fGrid->GetRules().IsClassic())
+		remaining = fDistances.MinimumMoves(fHistory.Board());
+
 	BString string("Moves: ");
 	string << count;
+	if (remaining >= 0)
+		string << " (" << remaining << " to go)";
+
+	const BRect frame = fMovesLabel->Frame();
+
 	fMovesLabel->SetText(string.String());
+	fMovesLabel->ResizeToPreferred();
+	fMovesLabel->MoveTo(frame.right - fMovesLabel->Frame().Width(),
+		frame.top);
 }
 
 void GridView::HandleFinish()
 {
+	const session_outcome outcome
+		= FinishOutcome(fMovesRequired, fHistory.Position());
+	fRecorder.Finish(system_time(), fHistory.Position(), outcome);
+	fRecorder.Flush();
+
 	if (fPuzzle == NULL) {
 		Success();
 		SetLevel(fLevel);
@@ -623,8 +769,8 @@ void GridView::HandleFinish()
 
 	// Determine whether or not the user finished in the required number of
 	// moves
-	int8 movesreq = fPuzzle->MovesRequired(fLevel);
-	if(fMoveCount > (movesreq+10))
+	int32 movesreq = fMovesRequired;
+	if(outcome == kTooManyMovesOutcome)
 	{
 		if(fUseSound && fNoWinSound != NULL)
 			fNoWinSound->StartPlaying();
@@ -668,20 +814,23 @@ void GridView::StartupPreferences()
 		for (int8 index = 0; index <= maxDimension - minDimension; index++)
 			lastLevels[index] = preferences.GetInt8("levels", index, index + 1);
 
-		for(int8 index = 0; index < gPuzzles.CountPacks(); index++) {
+		for(int32 index = 0; index < gPuzzles.CountPacks(); index++) {
 			PuzzlePack* pack = gPuzzles.PackAt(index);
-			pack->SetHighest(preferences.GetInt8(pack->Name(), 0));
+			// packs can have more levels than an int8 holds nowadays
+			pack->SetHighest(preferences.GetInt32(pack->Name(),
+				preferences.GetInt8(pack->Name(), 0)));
 		}
 
 		BString lastpack;
 
 		if (preferences.FindString("lastpack", &lastpack) == B_OK)
-			for(int8 index = 0; index < gPuzzles.CountPacks(); index++) {
+			for(int32 index = 0; index < gPuzzles.CountPacks(); index++) {
 				PuzzlePack* pack = gPuzzles.PackAt(index);
 
-				if (strcmp(lastpack.String(), pack->Name()) == 0) {
+				if (IsPlayable(pack)
+					&& strcmp(lastpack.String(), pack->Name()) == 0) {
 					fPuzzle = pack;
-					fDimension = defaultDimension;
+					fDimension = pack->Dimension();
 					break;
 				}
 			}
@@ -698,7 +847,7 @@ void GridView::StartupPreferences()
 			lastLevels[index] = index + 1;
 
 		fPuzzle = gPuzzles.PackAt(0);
-		fDimension = defaultDimension;
+		fDimension = fPuzzle->Dimension();
 		fRandomMenu->ItemAt(defaultDimension - minDimension)->SetMarked(true);
 		fUseSound = true;
 	}
@@ -715,12 +864,12 @@ void GridView::ShutdownPreferences()
 		preferences.AddInt8("levels", lastLevels[index]);
 
 	// Save the progress in each of the puzzle packs
-	for (int8 i = 0; i < gPuzzles.CountPacks(); i++) {
+	for (int32 i = 0; i < gPuzzles.CountPacks(); i++) {
 		PuzzlePack *pack = (PuzzlePack*)gPuzzles.PackAt(i);
 
 		if(pack) {
 			preferences.AddString("name",pack->Name());
-			preferences.AddInt8(pack->Name(), pack->Highest());
+			preferences.AddInt32(pack->Name(), pack->Highest());
 		}
 	}
 
@@ -5,8 +5,12 @@
 #include <Menu.h>
 #include <StringView.h>
 
+#include "DistanceDatabase.h"
 #include "Grid.h"
+#include "HintEngine.h"
+#include "MoveHistory.h"
 #include "PuzzlePack.h"
+#include "SessionLog.h"
 #include "TwoStateDrawButton.h"
 
 class GridView : public BView
@@ -23,14 +27,14 @@ public:
 private:
 	void RandomMenu();
 	void PressButton(int8 index);
-	void FlipButton(int8 offset);
+	void ShowBoard(uint64 values);
 	void UpdateButtons();
 	void UpdateGrid(BRect rect, int8 oldDimension);
 	void UpdateDimension(int8 dimension);
-	void SetLevel(int8 level);
+	void SetLevel(int32 level);
 	void SetRandom(int8 dimension);
 	void SetPack(PuzzlePack *pack);
-	void SetMovesLabel(int8 count);
+	void SetMovesLabel(int32 count);
 	void HandleFinish();
 	void Success();
 	void LoadSoundFiles();
@@ -38,6 +42,8 @@ private:
 	void Undo();
 	void Redo();
 	void Restore();
+	void SwitchBranch(bool next);
+	void ShowHint();
 
 	TwoStateDrawButton **fButtons;
 	BMenu *fMenu, *fSoundMenu, *fRandomMenu, *fPackMenu, *fLevelMenu;
@@ -47,9 +53,14 @@ private:
 	PuzzlePack *fPuzzle;
 
 	bool fUseSound;
-	int8 fDimension, fLevel, fMoveCount, fCurrentCount;
-	uint64 fPuzzleValues, fGridValues;
-	std::vector<int8> fMoves;
+	int8 fDimension;
+	int32 fLevel;
+	int32 fMovesRequired;
+	MoveHistory fHistory;
+	HintEngine fHints;
+	DistanceDatabase fDistances;
+	SessionRecorder fRecorder;
+	RandomGenerator fRandom;
 
 	BFileGameSound *fClickSound, *fWinSound, *fNoWinSound;
 };
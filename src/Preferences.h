@@ -9,6 +9,10 @@ extern BLocker prefsLock;
 extern BMessage preferences;
 
 #define PREFERENCES_PATH "/boot/home/config/settings/LightsOff"
+#define SESSIONS_PATH "/boot/home/config/settings/LightsOff sessions"
+#define DISTANCES_PATH "/boot/home/config/settings/LightsOff distances"
+#define PACKS_PATH "/boot/home/config/settings/LightsOff packs"
+#define PACK_INDEX_PATH "/boot/home/config/settings/LightsOff pack index"
 
 status_t SavePreferences(const char *path);
 status_t LoadPreferences(const char *path);
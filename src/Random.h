@@ -1,8 +0,0 @@
-#ifndef RANDOM_H
-#define RANDOM_H
-
-int		ChooseRandom(int array[], int n, int k);
-int		ChooseRandom4x4(int array[], int k);
-void	ChooseRandom5x5(int array[], int k);
-
-#endif
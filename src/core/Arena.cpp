@@ -0,0 +1,73 @@
+#include "Arena.h"
+
+#include <stdlib.h>
+
+
+Arena::Arena(size_t chunkSize)
+	:
+	fChunkSize(chunkSize),
+	fCurrent(0),
+	fOffset(0),
+	fUsed(0)
+{
+}
+
+Arena::~Arena()
+{
+	for (size_t index = 0; index < fChunks.size(); index++)
+		free(fChunks[index].base);
+}
+
+/*
+ * Room for size bytes at the given alignment, which must be a power of two,
+ * or NULL if there is no memory left. The memory isn't cleared.
+ */
+
+void* Arena::Allocate(size_t size, size_t alignment)
+{
+	for (; fCurrent < fChunks.size(); fCurrent++, fOffset = 0) {
+		const chunk& current = fChunks[fCurrent];
+		const size_t start = (fOffset + alignment - 1) & ~(alignment - 1);
+
+		if (start <= current.size && size <= current.size - start) {
+			fOffset = start + size;
+			fUsed += size;
+			return current.base + start;
+		}
+	}
+
+	// chunks come from malloc(), so their start is aligned for any type
+	chunk added;
+	added.size = size > fChunkSize ? size : fChunkSize;
+	added.base = (uint8*) malloc(added.size);
+	if (added.base == NULL)
+		return NULL;
+
+	fChunks.push_back(added);
+	fCurrent = fChunks.size() - 1;
+	fOffset = size;
+	fUsed += size;
+
+	return added.base;
+}
+
+void Arena::Reset()
+{
+	fCurrent = 0;
+	fOffset = 0;
+	fUsed = 0;
+}
+
+size_t Arena::Used() const
+{
+	return fUsed;
+}
+
+size_t Arena::Reserved() const
+{
+	size_t reserved = 0;
+	for (size_t index = 0; index < fChunks.size(); index++)
+		reserved += fChunks[index].size;
+
+	return reserved;
+}
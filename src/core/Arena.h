@@ -0,0 +1,50 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+
+#include "CoreDefs.h"
+
+// The Arena class hands out memory from a few large chunks. There is no way
+// to free a single allocation: Reset() takes everything back at once but
+// keeps the chunks, so a job that runs over and over with about the same
+// memory needs stops calling malloc() after the first run.
+
+class Arena
+{
+public:
+	enum { kDefaultChunkSize = 1024 * 1024 };
+
+	Arena(size_t chunkSize = kDefaultChunkSize);
+	~Arena();
+
+	void* Allocate(size_t size, size_t alignment = sizeof(uint64));
+
+	template<typename Type>
+	Type* Allocate(size_t count)
+	{
+		return (Type*) Allocate(count * sizeof(Type), alignof(Type));
+	}
+
+	void Reset();
+
+	size_t Used() const;
+	size_t Reserved() const;
+
+private:
+	Arena(const Arena&);
+	Arena& operator=(const Arena&);
+
+	struct chunk {
+		uint8*	base;
+		size_t	size;
+	};
+
+	size_t fChunkSize;
+	std::vector<chunk> fChunks;
+	size_t fCurrent;
+	size_t fOffset;
+	size_t fUsed;
+};
+
+#endif
@@ -0,0 +1,185 @@
+#include "Board.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "BoardKernels.h"
+
+// below this the call through the kernel table costs more than it saves
+static const int8 minKernelDimension = 16;
+
+Board::Board(int8 dimension)
+{
+	SetDimension(dimension);
+}
+
+void Board::SetDimension(int8 dimension)
+{
+	assert(dimension >= 0 && dimension <= kMaxDimension);
+
+	fDimension = dimension;
+	fRowMask = dimension == 64 ? ~(uint64) 0 : ((uint64) 1 << dimension) - 1;
+	Clear();
+}
+
+void Board::SetValue(int8 x, int8 y, bool isOn)
+{
+	const uint64 bit = (uint64) 1 << x;
+
+	if (isOn)
+		fRows[y] |= bit;
+	else
+		fRows[y] &= ~bit;
+}
+
+/*
+ * Toggle the light at (x, y) and its neighbors above, below, left and right.
+ */
+
+void Board::Press(int8 x, int8 y)
+{
+	const uint64 bit = (uint64) 1 << x;
+
+	fRows[y] ^= (bit | bit << 1 | bit >> 1) & fRowMask;
+
+	if (y > 0)
+		fRows[y - 1] ^= bit;
+
+	if (y < fDimension - 1)
+		fRows[y + 1] ^= bit;
+}
+
+/*
+ * Press every button that is set in presses.
+ */
+
+void Board::PressAll(const Board& presses)
+{
+	assert(fDimension == presses.fDimension);
+
+	if (fDimension >= minKernelDimension) {
+		BoardKernels().PressRows(fRows, presses.fRows, fDimension, fRowMask);
+		return;
+	}
+
+	for (int8 y = 0; y < fDimension; y++) {
+		const uint64 row = presses.fRows[y];
+		uint64 toggled = row ^ (row << 1 & fRowMask) ^ row >> 1;
+
+		if (y > 0)
+			toggled ^= presses.fRows[y - 1];
+
+		if (y < fDimension - 1)
+			toggled ^= presses.fRows[y + 1];
+
+		fRows[y] ^= toggled;
+	}
+}
+
+void Board::Clear()
+{
+	memset(fRows, 0, sizeof(fRows));
+}
+
+bool Board::IsZero() const
+{
+	if (fDimension >= minKernelDimension)
+		return BoardKernels().IsZero(fRows, fDimension);
+
+	uint64 any = 0;
+
+	for (int8 y = 0; y < fDimension; y++)
+		any |= fRows[y];
+
+	return any == 0;
+}
+
+int32 Board::CountLights() const
+{
+	int32 count = 0;
+
+	for (int8 y = 0; y < fDimension; y++)
+		count += __builtin_popcountll(fRows[y]);
+
+	return count;
+}
+
+Board& Board::operator^=(const Board& other)
+{
+	assert(fDimension == other.fDimension);
+
+	if (fDimension >= minKernelDimension) {
+		BoardKernels().XorRows(fRows, other.fRows, fDimension);
+		return *this;
+	}
+
+	for (int8 y = 0; y < fDimension; y++)
+		fRows[y] ^= other.fRows[y];
+
+	return *this;
+}
+
+bool Board::operator==(const Board& other) const
+{
+	if (fDimension != other.fDimension)
+		return false;
+
+	uint64 difference = 0;
+
+	for (int8 y = 0; y < fDimension; y++)
+		difference |= fRows[y] ^ other.fRows[y];
+
+	return difference == 0;
+}
+
+void Board::SetValues(uint64 values)
+{
+	assert(fDimension <= 8);
+
+	for (int8 y = 0; y < fDimension; y++)
+		fRows[y] = (values >> (y * fDimension)) & fRowMask;
+}
+
+uint64 Board::Values() const
+{
+	assert(fDimension <= 8);
+
+	uint64 values = 0;
+
+	for (int8 y = 0; y < fDimension; y++)
+		values |= fRows[y] << (y * fDimension);
+
+	return values;
+}
+
+void Board::Pack(uint64* words) const
+{
+	const int32 numWords = (CountButtons() + 63) / 64;
+
+	memset(words, 0, numWords * sizeof(uint64));
+
+	for (int8 y = 0; y < fDimension; y++) {
+		const int32 offset = y * fDimension;
+		const int32 word = offset / 64;
+		const int32 shift = offset % 64;
+
+		words[word] |= fRows[y] << shift;
+		if (shift != 0 && shift + fDimension > 64)
+			words[word + 1] |= fRows[y] >> (64 - shift);
+	}
+}
+
+void Board::Unpack(const uint64* words)
+{
+	for (int8 y = 0; y < fDimension; y++) {
+		const int32 offset = y * fDimension;
+		const int32 word = offset / 64;
+		const int32 shift = offset % 64;
+
+		uint64 row = words[word] >> shift;
+		if (shift != 0 && shift + fDimension > 64)
+			row |= words[word + 1] << (64 - shift);
+
+		fRows[y] = row & fRowMask;
+	}
+}
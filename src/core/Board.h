@@ -0,0 +1,65 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include "CoreDefs.h"
+
+// The Board class holds the lights of grids of any size up to 64x64, where a
+// single uint64 as used by Grid is not enough. Each row is one word, with
+// the light at (x, y) in bit x of row y, so a press touches at most three
+// words and whole-board operations run over n words.
+//
+// The rows live in the object itself, so boards can be copied and kept in
+// containers without any allocation. Boards of 16x16 and up go through the
+// SIMD kernels of BoardKernels() for whole-board operations.
+
+class Board
+{
+public:
+	enum { kMaxDimension = 64 };
+
+	Board(int8 dimension = 0);
+
+	void SetDimension(int8 dimension);
+	int8 Dimension() const { return fDimension; }
+	int32 CountButtons() const { return fDimension * fDimension; }
+
+	uint64 Row(int8 y) const { return fRows[y]; }
+	void SetRow(int8 y, uint64 row) { fRows[y] = row & fRowMask; }
+	uint64 RowMask() const { return fRowMask; }
+
+	bool ValueAt(int8 x, int8 y) const { return (fRows[y] >> x) & 1; }
+	bool ValueAt(int32 offset) const
+		{ return ValueAt(offset % fDimension, offset / fDimension); }
+	void SetValue(int8 x, int8 y, bool isOn);
+	void FlipValueAt(int8 x, int8 y) { fRows[y] ^= (uint64) 1 << x; }
+	void FlipValueAt(int32 offset)
+		{ FlipValueAt(offset % fDimension, offset / fDimension); }
+
+	void Press(int8 x, int8 y);
+	void Press(int32 offset)
+		{ Press(offset % fDimension, offset / fDimension); }
+	void PressAll(const Board& presses);
+
+	void Clear();
+	bool IsZero() const;
+	int32 CountLights() const;
+
+	Board& operator^=(const Board& other);
+	bool operator==(const Board& other) const;
+	bool operator!=(const Board& other) const { return !(*this == other); }
+
+	// for boards up to 8x8, in the layout of Grid::GetGridValues()
+	void SetValues(uint64 values);
+	uint64 Values() const;
+
+	// light i in bit (i % 64) of word (i / 64), as used by Solver
+	void Pack(uint64* words) const;
+	void Unpack(const uint64* words);
+
+private:
+	int8 fDimension;
+	uint64 fRowMask;
+	uint64 fRows[kMaxDimension];
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "BoardDistances.h"
+
+#include <algorithm>
+
+
+BoardDistances::BoardDistances()
+	:
+	fDimension(0),
+	fNumBoards(0),
+	fNumBlocks(0),
+	fDistances(NULL),
+	fIndex(NULL),
+	fNumLevels(0)
+{
+}
+
+/*
+ * Read the distance table and the level index of numLevels move counts for
+ * dimension from now on. Both have to stay around as long as this does.
+ */
+
+void BoardDistances::SetTo(int8 dimension, const uint8* distances,
+	const uint32* index, int32 numLevels)
+{
+	fDimension = dimension;
+	fNumBoards = (uint64) 1 << (dimension * dimension);
+	fNumBlocks = CountBlocks(dimension);
+	fDistances = distances;
+	fIndex = index;
+	fNumLevels = numLevels;
+}
+
+/*
+ * The number of presses in an optimal solution, or -1 if there is none. The
+ * board uses the layout of Grid::GetGridValues().
+ */
+
+int32 BoardDistances::MinimumMoves(uint64 board) const
+{
+	if (fDistances == NULL || board >= fNumBoards)
+		return -1;
+
+	const int32 moves = (fDistances[board / 2] >> ((board & 1) * 4)) & 0xf;
+
+	// only the empty board and unsolvable ones read as zero
+	if (moves == 0 && board != 0)
+		return -1;
+
+	return moves;
+}
+
+uint64 BoardDistances::CountBoards(int32 moves) const
+{
+	if (moves < 0 || moves >= fNumLevels)
+		return 0;
+
+	return fIndex[moves * (fNumBlocks + 1) + fNumBlocks];
+}
+
+/*
+ * A board drawn uniformly from all those whose optimal solution takes
+ * exactly moves presses, or 0 if there are none. The boards of a move count
+ * are numbered in ascending order, and the one drawn is found in the block
+ * whose count before it is the last not above its number.
+ */
+
+uint64 BoardDistances::RandomBoard(int32 moves,
+	RandomGenerator& generator) const
+{
+	const uint64 count = CountBoards(moves);
+	if (count == 0)
+		return 0;
+
+	const uint32* before = fIndex + moves * (fNumBlocks + 1);
+	uint32 number = generator.Uniform(count);
+
+	const uint64 block
+		= std::upper_bound(before, before + fNumBlocks, number) - before - 1;
+	number -= before[block];
+
+	for (uint64 board = block * kBlockSize;; board++) {
+		if (MinimumMoves(board) == moves && number-- == 0)
+			return board;
+	}
+}
+
+uint64 BoardDistances::CountBlocks(int8 dimension)
+{
+	const uint64 numBoards = (uint64) 1 << (dimension * dimension);
+	return (numBoards + kBlockSize - 1) / kBlockSize;
+}
@@ -0,0 +1,54 @@
+#ifndef BOARD_DISTANCES_H
+#define BOARD_DISTANCES_H
+
+#include "CoreDefs.h"
+#include "Random.h"
+
+// The BoardDistances class reads the optimal move count of every board of a
+// dimension up to 5x5 out of tables it doesn't own: StateSpace builds them in
+// memory, and DistanceDatabase maps them from a file.
+//
+// The distance table takes a nibble per board, indexed by the board value
+// itself, two boards per byte with the even board in the low nibble. Boards
+// that can't be solved are stored as zero, which no board but the empty one
+// can otherwise have.
+//
+// The level index splits the boards into blocks of kBlockSize and holds, for
+// each move count in turn, how many boards of that count come before each
+// block, followed by how many there are in all. Drawing a board of a move
+// count is then a binary search over the blocks and a scan of one of them: a
+// few microseconds that only touch the pages they read, where collecting all
+// boards of the count would mean reading the whole table.
+
+class BoardDistances
+{
+public:
+	enum { kBlockSize = 4096 };
+
+	BoardDistances();
+
+	void SetTo(int8 dimension, const uint8* distances, const uint32* index,
+		int32 numLevels);
+
+	int8 Dimension() const { return fDimension; }
+	uint64 NumBoards() const { return fNumBoards; }
+
+	int32 MinimumMoves(uint64 board) const;
+	int32 MaxMoves() const { return fNumLevels - 1; }
+	uint64 CountBoards(int32 moves) const;
+
+	uint64 RandomBoard(int32 moves,
+		RandomGenerator& generator = RandomGenerator::ForThread()) const;
+
+	static uint64 CountBlocks(int8 dimension);
+
+private:
+	int8 fDimension;
+	uint64 fNumBoards;
+	uint64 fNumBlocks;
+	const uint8* fDistances;
+	const uint32* fIndex;
+	int32 fNumLevels;
+};
+
+#endif
@@ -0,0 +1,273 @@
+#include "BoardKernels.h"
+
+#include <assert.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#	define HAVE_X86_KERNELS 1
+#	include <immintrin.h>
+#endif
+
+
+// #pragma mark - scalar
+
+
+static void
+XorRowsScalar(uint64* dest, const uint64* source, int32 count)
+{
+	for (int32 y = 0; y < count; y++)
+		dest[y] ^= source[y];
+}
+
+
+static inline uint64
+PressRow(const uint64* presses, int32 y, int32 count, uint64 rowMask)
+{
+	const uint64 row = presses[y];
+	uint64 toggled = row ^ (row << 1 & rowMask) ^ row >> 1;
+
+	if (y > 0)
+		toggled ^= presses[y - 1];
+
+	if (y < count - 1)
+		toggled ^= presses[y + 1];
+
+	return toggled;
+}
+
+
+static void
+PressRowsScalar(uint64* dest, const uint64* presses, int32 count,
+	uint64 rowMask)
+{
+	for (int32 y = 0; y < count; y++)
+		dest[y] ^= PressRow(presses, y, count, rowMask);
+}
+
+
+static bool
+IsZeroScalar(const uint64* rows, int32 count)
+{
+	uint64 any = 0;
+
+	for (int32 y = 0; y < count; y++)
+		any |= rows[y];
+
+	return any == 0;
+}
+
+
+#ifdef HAVE_X86_KERNELS
+
+
+// #pragma mark - SSE2
+
+
+__attribute__((target("sse2")))
+static void
+XorRowsSSE2(uint64* dest, const uint64* source, int32 count)
+{
+	int32 y = 0;
+
+	for (; y + 2 <= count; y += 2) {
+		const __m128i rows = _mm_loadu_si128((const __m128i*) (source + y));
+		__m128i* target = (__m128i*) (dest + y);
+		_mm_storeu_si128(target, _mm_xor_si128(_mm_loadu_si128(target), rows));
+	}
+
+	for (; y < count; y++)
+		dest[y] ^= source[y];
+}
+
+
+/*
+ * The first and last rows only have one vertical neighbor and are done with
+ * the scalar code; every row in between takes the rows above and below from
+ * unaligned loads shifted by one row.
+ */
+
+__attribute__((target("sse2")))
+static void
+PressRowsSSE2(uint64* dest, const uint64* presses, int32 count,
+	uint64 rowMask)
+{
+	if (count < 4) {
+		PressRowsScalar(dest, presses, count, rowMask);
+		return;
+	}
+
+	const __m128i mask = _mm_set1_epi64x(rowMask);
+
+	dest[0] ^= PressRow(presses, 0, count, rowMask);
+
+	int32 y = 1;
+
+	for (; y + 2 <= count - 1; y += 2) {
+		const __m128i row = _mm_loadu_si128((const __m128i*) (presses + y));
+		const __m128i above
+			= _mm_loadu_si128((const __m128i*) (presses + y - 1));
+		const __m128i below
+			= _mm_loadu_si128((const __m128i*) (presses + y + 1));
+
+		__m128i toggled = _mm_xor_si128(row,
+			_mm_and_si128(_mm_slli_epi64(row, 1), mask));
+		toggled = _mm_xor_si128(toggled, _mm_srli_epi64(row, 1));
+		toggled = _mm_xor_si128(toggled, _mm_xor_si128(above, below));
+
+		__m128i* target = (__m128i*) (dest + y);
+		_mm_storeu_si128(target,
+			_mm_xor_si128(_mm_loadu_si128(target), toggled));
+	}
+
+	for (; y < count; y++)
+		dest[y] ^= PressRow(presses, y, count, rowMask);
+}
+
+
+__attribute__((target("sse2")))
+static bool
+IsZeroSSE2(const uint64* rows, int32 count)
+{
+	__m128i any = _mm_setzero_si128();
+	int32 y = 0;
+
+	for (; y + 2 <= count; y += 2)
+		any = _mm_or_si128(any, _mm_loadu_si128((const __m128i*) (rows + y)));
+
+	uint64 rest = 0;
+	for (; y < count; y++)
+		rest |= rows[y];
+
+	return rest == 0 && _mm_movemask_epi8(
+		_mm_cmpeq_epi8(any, _mm_setzero_si128())) == 0xffff;
+}
+
+
+// #pragma mark - AVX2
+
+
+__attribute__((target("avx2")))
+static void
+XorRowsAVX2(uint64* dest, const uint64* source, int32 count)
+{
+	int32 y = 0;
+
+	for (; y + 4 <= count; y += 4) {
+		const __m256i rows
+			= _mm256_loadu_si256((const __m256i*) (source + y));
+		__m256i* target = (__m256i*) (dest + y);
+		_mm256_storeu_si256(target,
+			_mm256_xor_si256(_mm256_loadu_si256(target), rows));
+	}
+
+	for (; y < count; y++)
+		dest[y] ^= source[y];
+}
+
+
+__attribute__((target("avx2")))
+static void
+PressRowsAVX2(uint64* dest, const uint64* presses, int32 count,
+	uint64 rowMask)
+{
+	if (count < 6) {
+		PressRowsScalar(dest, presses, count, rowMask);
+		return;
+	}
+
+	const __m256i mask = _mm256_set1_epi64x(rowMask);
+
+	dest[0] ^= PressRow(presses, 0, count, rowMask);
+
+	int32 y = 1;
+
+	for (; y + 4 <= count - 1; y += 4) {
+		const __m256i row
+			= _mm256_loadu_si256((const __m256i*) (presses + y));
+		const __m256i above
+			= _mm256_loadu_si256((const __m256i*) (presses + y - 1));
+		const __m256i below
+			= _mm256_loadu_si256((const __m256i*) (presses + y + 1));
+
+		__m256i toggled = _mm256_xor_si256(row,
+			_mm256_and_si256(_mm256_slli_epi64(row, 1), mask));
+		toggled = _mm256_xor_si256(toggled, _mm256_srli_epi64(row, 1));
+		toggled = _mm256_xor_si256(toggled, _mm256_xor_si256(above, below));
+
+		__m256i* target = (__m256i*) (dest + y);
+		_mm256_storeu_si256(target,
+			_mm256_xor_si256(_mm256_loadu_si256(target), toggled));
+	}
+
+	for (; y < count; y++)
+		dest[y] ^= PressRow(presses, y, count, rowMask);
+}
+
+
+__attribute__((target("avx2")))
+static bool
+IsZeroAVX2(const uint64* rows, int32 count)
+{
+	__m256i any = _mm256_setzero_si256();
+	int32 y = 0;
+
+	for (; y + 4 <= count; y += 4)
+		any = _mm256_or_si256(any,
+			_mm256_loadu_si256((const __m256i*) (rows + y)));
+
+	uint64 rest = 0;
+	for (; y < count; y++)
+		rest |= rows[y];
+
+	return rest == 0 && _mm256_testz_si256(any, any);
+}
+
+
+#endif	// HAVE_X86_KERNELS
+
+
+// #pragma mark - dispatch
+
+
+static const board_kernels sKernels[] = {
+	{ "scalar", XorRowsScalar, PressRowsScalar, IsZeroScalar },
+#ifdef HAVE_X86_KERNELS
+	{ "sse2", XorRowsSSE2, PressRowsSSE2, IsZeroSSE2 },
+	{ "avx2", XorRowsAVX2, PressRowsAVX2, IsZeroAVX2 },
+#endif
+};
+
+
+int32
+CountBoardKernels()
+{
+#ifdef HAVE_X86_KERNELS
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2"))
+		return 3;
+
+	if (__builtin_cpu_supports("sse2"))
+		return 2;
+#endif
+
+	return 1;
+}
+
+
+const board_kernels&
+BoardKernelsAt(int32 index)
+{
+	assert(index >= 0 && index < CountBoardKernels());
+
+	return sKernels[index];
+}
+
+
+const board_kernels&
+BoardKernels()
+{
+	static const board_kernels& kernels
+		= BoardKernelsAt(CountBoardKernels() - 1);
+
+	return kernels;
+}
@@ -0,0 +1,30 @@
+#ifndef BOARD_KERNELS_H
+#define BOARD_KERNELS_H
+
+#include "CoreDefs.h"
+
+// Whole-board operations on the one-word-per-row layout of Board, in a
+// scalar version and, on x86, SSE2 and AVX2 versions that handle two or four
+// rows per instruction. BoardKernels() picks the widest set the CPU supports
+// the first time it is called; all sets give bit-identical results.
+//
+//	XorRows		dest[y] ^= source[y]
+//	PressRows	dest[y] ^= the lights toggled by pressing every button set in
+//				presses, the same toggles Grid::Press makes one at a time
+//	IsZero		whether every row is zero
+
+struct board_kernels {
+	const char*	name;
+	void		(*XorRows)(uint64* dest, const uint64* source, int32 count);
+	void		(*PressRows)(uint64* dest, const uint64* presses, int32 count,
+					uint64 rowMask);
+	bool		(*IsZero)(const uint64* rows, int32 count);
+};
+
+const board_kernels& BoardKernels();
+
+// every kernel set this CPU can run, the scalar one first
+int32 CountBoardKernels();
+const board_kernels& BoardKernelsAt(int32 index);
+
+#endif
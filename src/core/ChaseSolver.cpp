@@ -0,0 +1,146 @@
+#include "ChaseSolver.h"
+
+#include <assert.h>
+
+#include <mutex>
+
+#include "Grid.h"
+#include "Solver.h"
+
+// built on first use and kept for the lifetime of the process
+static ChaseSolver* sChaseSolvers[9];
+static std::mutex sChaseSolversLock;
+
+
+/*
+ * The ChaseSolver for dimension. Any thread may ask for it: the first call
+ * builds its tables under the lock, and threads asking at the same time
+ * wait for them rather than build their own, so workers need not have it
+ * built for them up front.
+ */
+
+const ChaseSolver& ChaseSolver::ForDimension(int8 dimension)
+{
+	assert(dimension > 0 && dimension <= 8);
+
+	std::lock_guard<std::mutex> lock(sChaseSolversLock);
+
+	if (sChaseSolvers[dimension] == NULL)
+		sChaseSolvers[dimension] = new ChaseSolver(dimension);
+
+	return *sChaseSolvers[dimension];
+}
+
+/*
+ * Build the bottom row table by pressing every combination of top-row
+ * buttons on an empty grid and chasing the result down. Chasing is linear, so
+ * the presses for any top-row combination t that leaves bottom row pattern B
+ * also turn off B when it is left over from chasing another board.
+ */
+
+ChaseSolver::ChaseSolver(int8 dimension)
+	:
+	fDimension(dimension),
+	fRowMask(((uint64) 1 << dimension) - 1),
+	fFullMask(Grid::FullMask(dimension)),
+	fLeftColumn(0)
+{
+	assert(dimension > 0 && dimension <= 8);
+
+	for (int8 row = 0; row < dimension; row++)
+		fLeftColumn |= (uint64) 1 << (row * dimension);
+	fRightColumn = fLeftColumn << (dimension - 1);
+
+	const uint32 numPatterns = (uint32) 1 << dimension;
+
+	fBottomRow.assign(numPatterns, 0);
+	fBottomRowSolvable.assign(numPatterns, 0);
+
+	for (uint32 topRow = 0; topRow < numPatterns; topRow++) {
+		uint64 lights = _Spread(topRow);
+		const uint64 presses = topRow | _Chase(lights);
+		const uint32 bottomRow = lights >> ((dimension - 1) * dimension);
+
+		if (bottomRow == 0)
+			fQuietPatterns.push_back(presses);
+
+		if (!fBottomRowSolvable[bottomRow]) {
+			fBottomRow[bottomRow] = presses;
+			fBottomRowSolvable[bottomRow] = 1;
+		}
+	}
+}
+
+/*
+ * The lights toggled by pressing every button in presses.
+ */
+
+uint64 ChaseSolver::_Spread(uint64 presses) const
+{
+	const int8 n = fDimension;
+
+	return (presses ^ presses << n ^ presses >> n
+		^ (presses << 1 & ~fLeftColumn) ^ (presses >> 1 & ~fRightColumn))
+		& fFullMask;
+}
+
+/*
+ * Turn off the lights of every row but the last by pressing the buttons right
+ * below them, one row at a time. Returns the buttons pressed.
+ */
+
+uint64 ChaseSolver::_Chase(uint64& lights) const
+{
+	const int8 n = fDimension;
+	uint64 presses = 0;
+
+	for (int8 row = 0; row < n - 1; row++) {
+		const uint64 below = (lights & fRowMask << (row * n)) << n;
+
+		presses |= below;
+		lights ^= _Spread(below);
+	}
+
+	return presses;
+}
+
+bool ChaseSolver::Solve(uint64 lights, uint64& presses) const
+{
+	const uint64 chased = _Chase(lights);
+	const uint32 bottomRow = lights >> ((fDimension - 1) * fDimension);
+
+	if (!fBottomRowSolvable[bottomRow])
+		return false;
+
+	const uint64 solution = chased ^ fBottomRow[bottomRow];
+
+	uint64 best = solution;
+	int32 bestCount = CountBits(best);
+
+	for (size_t index = 1; index < fQuietPatterns.size(); index++) {
+		const uint64 candidate = solution ^ fQuietPatterns[index];
+		const int32 count = CountBits(candidate);
+
+		if (count < bestCount) {
+			best = candidate;
+			bestCount = count;
+		}
+	}
+
+	presses = best;
+	return true;
+}
+
+/*
+ * The number of presses in an optimal solution, or -1 if there is none.
+ */
+
+int32 ChaseSolver::MinimumMoves(uint64 lights) const
+{
+	uint64 presses;
+
+	if (!Solve(lights, presses))
+		return -1;
+
+	return CountBits(presses);
+}
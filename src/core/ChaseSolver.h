@@ -0,0 +1,49 @@
+#ifndef CHASE_SOLVER_H
+#define CHASE_SOLVER_H
+
+#include <vector>
+
+#include "CoreDefs.h"
+
+// The ChaseSolver class solves grids up to 8x8 the way people do it by hand:
+// "chase the lights" down the grid by pressing, in each row, the buttons
+// below the lights still on in the row above, and then look up which top-row
+// presses clear whatever is left in the bottom row. Chasing a row is a
+// handful of word operations on the bitboard, so a solve costs n - 1 of
+// those plus a table lookup and a walk over the (at most 16) presses that
+// leave every light alone.
+//
+// It gives the same move counts as Solver and is meant for the small fixed
+// dimensions of the puzzle packs.
+
+class ChaseSolver
+{
+public:
+	ChaseSolver(int8 dimension);
+
+	static const ChaseSolver& ForDimension(int8 dimension);
+
+	int8 Dimension() const { return fDimension; }
+
+	bool Solve(uint64 lights, uint64& presses) const;
+	int32 MinimumMoves(uint64 lights) const;
+
+private:
+	uint64 _Chase(uint64& lights) const;
+	uint64 _Spread(uint64 presses) const;
+
+	int8 fDimension;
+	uint64 fRowMask;
+	uint64 fFullMask;
+	uint64 fLeftColumn;
+	uint64 fRightColumn;
+
+	// indexed by the lights left in the bottom row after chasing: the full
+	// press set that turns them off, and whether there is one at all
+	std::vector<uint64> fBottomRow;
+	std::vector<uint8> fBottomRowSolvable;
+	// every press set that leaves the grid unchanged
+	std::vector<uint64> fQuietPatterns;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef CORE_DEFS_H
+#define CORE_DEFS_H
+
+// The core sources only need the fixed-size integer types and status_t. On
+// Haiku they come from SupportDefs.h; elsewhere the same names are defined
+// on top of stdint.h and errno.h so the core builds without the Haiku
+// headers. As on Haiku, errors are negative and convert to and from errno
+// values with B_FROM_POSIX_ERROR() and B_TO_POSIX_ERROR().
+
+#ifdef __HAIKU__
+#include <SupportDefs.h>
+#else
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int8_t		int8;
+typedef uint8_t		uint8;
+typedef int16_t		int16;
+typedef uint16_t	uint16;
+typedef int32_t		int32;
+typedef uint32_t	uint32;
+typedef int64_t		int64;
+typedef uint64_t	uint64;
+
+typedef int32		status_t;
+
+#define B_FROM_POSIX_ERROR(error)	(-(error))
+#define B_TO_POSIX_ERROR(error)		(-(error))
+
+#define B_OK				0
+#define B_ERROR				(-1)
+#define B_NO_MEMORY			B_FROM_POSIX_ERROR(ENOMEM)
+#define B_BAD_VALUE			B_FROM_POSIX_ERROR(EINVAL)
+#define B_BAD_DATA			B_FROM_POSIX_ERROR(EBADMSG)
+#define B_NO_INIT			B_FROM_POSIX_ERROR(ENXIO)
+#define B_NOT_SUPPORTED		B_FROM_POSIX_ERROR(EOPNOTSUPP)
+#endif
+
+#endif
@@ -0,0 +1,180 @@
+#include "DistanceDatabase.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "StateSpace.h"
+
+static const char magic[8] = { 'L', 'O', 'D', 'I', 'S', 'T', 'D', 'B' };
+
+
+DistanceDatabase::DistanceDatabase()
+{
+	memset(&fHeader, 0, sizeof(fHeader));
+}
+
+DistanceDatabase::~DistanceDatabase()
+{
+	Close();
+}
+
+/*
+ * Map the database at path and check that its header describes a table
+ * and level index this version can read, and that the file is large enough
+ * to hold them.
+ */
+
+status_t DistanceDatabase::Open(const char* path)
+{
+	Close();
+
+	distance_database_header header;
+	status_t status = fFile.ReadHeader(path, &header, sizeof(header),
+		kDataOffset);
+	if (status != B_OK)
+		return status;
+
+	if (memcmp(header.magic, magic, sizeof(magic)) != 0
+		|| header.version != kVersion || header.bitsPerBoard != 4
+		|| header.dimension < 1
+		|| header.dimension > StateSpace::kMaxDimension
+		|| header.numLevels < 1 || header.numLevels > 16) {
+		fFile.Close();
+		return B_BAD_DATA;
+	}
+
+	const uint64 numBoards
+		= (uint64) 1 << (header.dimension * header.dimension);
+	const uint64 indexSize = header.numLevels
+		* (BoardDistances::CountBlocks(header.dimension) + 1)
+		* sizeof(uint32);
+
+	if (header.numBoards != numBoards
+		|| header.dataSize != (numBoards + 1) / 2
+		|| header.indexOffset != _IndexOffset(header.dataSize)
+		|| header.indexSize != indexSize) {
+		fFile.Close();
+		return B_BAD_DATA;
+	}
+
+	// lookups jump all over the table
+	status = fFile.Map(header.indexOffset + header.indexSize, true);
+	if (status != B_OK)
+		return status;
+
+	fHeader = header;
+	fDistances.SetTo(header.dimension, fFile.Data() + kDataOffset,
+		(const uint32*) (fFile.Data() + header.indexOffset),
+		header.numLevels);
+
+	return B_OK;
+}
+
+void DistanceDatabase::Close()
+{
+	fFile.Close();
+
+	memset(&fHeader, 0, sizeof(fHeader));
+	fDistances = BoardDistances();
+}
+
+status_t DistanceDatabase::InitCheck() const
+{
+	return fHeader.dimension != 0 ? B_OK : B_NO_INIT;
+}
+
+/*
+ * Compare the table and its index against the checksum in the header. This
+ * reads every page of the file, so it's meant for tools rather than the
+ * application.
+ */
+
+status_t DistanceDatabase::Verify() const
+{
+	if (fHeader.dimension == 0)
+		return B_NO_INIT;
+
+	const uint8* data = fFile.Data();
+	const uint64 checksum = MappedFile::Checksum(data + fHeader.indexOffset,
+		fHeader.indexSize,
+		MappedFile::Checksum(data + kDataOffset, fHeader.dataSize));
+
+	if (checksum != fHeader.checksum)
+		return B_BAD_DATA;
+
+	return B_OK;
+}
+
+status_t DistanceDatabase::Write(const char* path, const StateSpace& space)
+{
+	distance_database_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = kVersion;
+	header.dimension = space.Dimension();
+	header.bitsPerBoard = 4;
+	header.numLevels = space.MaxMoves() + 1;
+	header.numBoards = (uint64) 1 << (space.Dimension() * space.Dimension());
+	header.dataSize = space.DataSize();
+	header.indexOffset = _IndexOffset(space.DataSize());
+	header.indexSize = space.IndexSize();
+	header.checksum = MappedFile::Checksum((const uint8*) space.Index(),
+		space.IndexSize(),
+		MappedFile::Checksum(space.Data(), space.DataSize()));
+
+	const std::string temporaryPath = std::string(path) + ".tmp";
+
+	FILE* file = fopen(temporaryPath.c_str(), "wb");
+	if (file == NULL)
+		return B_FROM_POSIX_ERROR(errno);
+
+	uint8 padding[kDataOffset] = { 0 };
+	memcpy(padding, &header, sizeof(header));
+
+	// the alignment of the index
+	const uint8 zeros[8] = { 0 };
+	const size_t numZeros = header.indexOffset - kDataOffset - header.dataSize;
+
+	bool written = fwrite(padding, 1, kDataOffset, file) == kDataOffset
+		&& fwrite(space.Data(), 1, space.DataSize(), file) == space.DataSize()
+		&& fwrite(zeros, 1, numZeros, file) == numZeros
+		&& fwrite(space.Index(), 1, space.IndexSize(), file)
+			== space.IndexSize();
+	status_t status = written ? B_OK : B_FROM_POSIX_ERROR(errno);
+
+	if (fclose(file) != 0 && status == B_OK)
+		status = B_FROM_POSIX_ERROR(errno);
+
+	if (status == B_OK && rename(temporaryPath.c_str(), path) != 0)
+		status = B_FROM_POSIX_ERROR(errno);
+
+	if (status != B_OK)
+		unlink(temporaryPath.c_str());
+
+	return status;
+}
+
+/*
+ * The path of the database of dimension in directory, as
+ * StateSpaceEnumerator names them.
+ */
+
+std::string DistanceDatabase::Path(const char* directory, int8 dimension)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "/distances-%dx%d", (int) dimension,
+		(int) dimension);
+
+	return directory + std::string(name);
+}
+
+/*
+ * Where the level index starts: right after the table, aligned for its
+ * entries.
+ */
+
+uint64 DistanceDatabase::_IndexOffset(uint64 dataSize)
+{
+	return (kDataOffset + dataSize + 7) & ~(uint64) 7;
+}
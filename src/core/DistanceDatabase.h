@@ -0,0 +1,83 @@
+#ifndef DISTANCE_DATABASE_H
+#define DISTANCE_DATABASE_H
+
+#include <string>
+
+#include "BoardDistances.h"
+#include "CoreDefs.h"
+#include "MappedFile.h"
+
+class StateSpace;
+
+// The DistanceDatabase class looks up the optimal move count of a board in a
+// StateSpace table that was written to disk, so it doesn't have to be worked
+// out again on every start. The file is mapped read-only instead of read in:
+// opening it costs a single page whatever the dimension, and only the pages
+// holding boards that are actually looked up are ever loaded. The kernel can
+// drop those again under memory pressure, and several processes share them.
+//
+// The file starts with a distance_database_header, in the byte order of the
+// machine that wrote it, followed by the nibble table of StateSpace::Data()
+// at kDataOffset and its level index at indexOffset, so that boards of any
+// move count can be drawn straight from the file through Distances(). Open()
+// checks the header but not the checksum, which would mean reading the whole
+// table; Verify() does that on request.
+//
+// Write() writes the file under a temporary name and renames it into place,
+// so a database that is opened while it's being written is either the old
+// one or missing.
+
+struct distance_database_header {
+	char	magic[8];
+	uint32	version;
+	uint8	dimension;
+	uint8	bitsPerBoard;
+	uint8	numLevels;		// of the level index, the highest move count + 1
+	uint8	reserved;
+	uint64	numBoards;
+	uint64	dataSize;
+	uint64	indexOffset;
+	uint64	indexSize;
+	uint64	checksum;		// FNV-1a of the data and then the index
+};
+
+
+class DistanceDatabase
+{
+public:
+	enum {
+		kVersion = 2,
+		kDataOffset = 4096	// keeps the table page aligned
+	};
+
+	DistanceDatabase();
+	~DistanceDatabase();
+
+	status_t Open(const char* path);
+	void Close();
+	status_t InitCheck() const;
+
+	status_t Verify() const;
+
+	int8 Dimension() const { return fHeader.dimension; }
+	uint64 NumBoards() const { return fHeader.numBoards; }
+
+	int32 MinimumMoves(uint64 board) const
+		{ return fDistances.MinimumMoves(board); }
+	const BoardDistances& Distances() const { return fDistances; }
+
+	static status_t Write(const char* path, const StateSpace& space);
+	static std::string Path(const char* directory, int8 dimension);
+
+private:
+	DistanceDatabase(const DistanceDatabase&);
+	DistanceDatabase& operator=(const DistanceDatabase&);
+
+	static uint64 _IndexOffset(uint64 dataSize);
+
+	distance_database_header fHeader;
+	MappedFile fFile;
+	BoardDistances fDistances;
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "Grid.h"
+
+#include <assert.h>
+
+#include "PuzzleGenerator.h"
+
+uint64 Grid::FullMask(int8 dimension)
+{
+	return rule_geometry(dimension).fullMask;
+}
+
+/*
+ * The lights toggled by pressing the button at offset under the classic
+ * rules: the button itself and its neighbors above, below, left and right.
+ */
+
+uint64 Grid::PressMask(int8 dimension, int8 offset)
+{
+	return ClassicRule::PressMask(rule_geometry(dimension), offset);
+}
+
+Grid::Grid(int8 dimension)
+	:
+	fClassic(true)
+{
+	SetDimension(dimension);
+}
+
+void Grid::SetDimension(int8 dimension)
+{
+	fDimension = dimension;
+	fData = 0;
+	fGeometry = rule_geometry(dimension);
+
+	assert(!fRules.IsToroidal() || dimension >= 3);
+}
+
+void Grid::SetRules(const Rules& rules)
+{
+	assert(!rules.IsToroidal() || fDimension >= 3);
+
+	fRules = rules;
+	fClassic = rules.IsClassic();
+}
+
+uint64 Grid::Press(int8 offset)
+{
+	const uint64 bit = (uint64) 1 << offset;
+	const uint64 mask = fClassic
+		? ClassicRule::Spread(fGeometry, bit) : fRules.Spread(fGeometry, bit);
+
+	fData ^= mask;
+	return mask;
+}
+
+
+/*
+ * Create a puzzle by pressing minMoves-many random buttons on an empty grid.
+ * Under the classic rules PuzzleGenerator picks the puzzle so that no
+ * solution with fewer moves exists, which makes every level exactly as hard
+ * as its number. Other rules just get minMoves different buttons.
+ */
+
+void Grid::Random(int8 minMoves, RandomGenerator& generator)
+{
+	const int8 numButtons = fDimension * fDimension;
+
+	// start with an empty grid
+	fData = 0;
+
+	/*
+	 * Some of the eigenvectors
+	 *
+	 * An eigenvector is a puzzle whose solution is simply pressing all lit
+	 * buttons in the puzzle. --Owen
+	 */
+#if 0
+	// 3x3.png
+	if (fDimension == 3 && minMoves == 8) {
+		fData = 0x1ef;
+		return;
+	}
+
+	// 6x6.png
+	if (fDimension == 6 && minMoves == 6) {
+		fData = 0x810204081ULL;
+		return;
+	}
+
+	// 7x7.png
+	if (fDimension == 7 && minMoves == 16) {
+		fData = 0x20a2aaaa8a08ULL;
+		return;
+	}
+
+	// 8x8.png
+	if (fDimension == 8 && minMoves == 14) {
+		fData = 0x2050a142850a040ULL;
+		return;
+	}
+#endif
+
+	if (minMoves > numButtons)
+		minMoves = numButtons;
+
+	if (fClassic) {
+		fData = PuzzleGenerator::ForDimension(fDimension)
+			.RandomPuzzle(minMoves, generator);
+		return;
+	}
+
+	uint64 presses = 0;
+
+	for (int8 count = 0; count < minMoves;) {
+		const uint64 bit = (uint64) 1 << generator.Uniform(numButtons);
+		if ((presses & bit) == 0) {
+			presses |= bit;
+			count++;
+		}
+	}
+
+	for (int8 offset = 0; presses != 0; offset++, presses >>= 1)
+		if (presses & 1)
+			Press(offset);
+}
+
+bool Grid::ValueAt(int8 x, int8 y)
+{
+	return ValueAt(x + y * fDimension);
+}
+
+bool Grid::ValueAt(int8 offset)
+{
+	return (fData >> offset) & 1;
+}
+
+void Grid::SetValue(int8 x, int8 y, bool isOn)
+{
+	SetValue(x + y * fDimension, isOn);
+}
+
+void Grid::SetValue(int8 offset, bool isOn)
+{
+	const uint64 bit = (uint64) 1 << offset;
+
+	if (isOn)
+		fData |= bit;
+	else
+		fData &= ~bit;
+}
+
+void Grid::SetGridValues(uint64 value)
+{
+	fData = value & fGeometry.fullMask;
+}
+
+uint64 Grid::GetGridValues() const
+{
+	return fData;
+}
+
+void Grid::FlipValueAt(int8 x, int8 y)
+{
+	FlipValueAt(x + y * fDimension);
+}
+
+void Grid::FlipValueAt(int8 offset)
+{
+	fData ^= (uint64) 1 << offset;
+}
@@ -0,0 +1,56 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include "CoreDefs.h"
+#include "Random.h"
+#include "Rules.h"
+
+// The Grid class performs data handling and translation for the lights
+// themselves and also makes it easy to write a level to disk. :)
+//
+// The lights are kept in a bitboard: bit (x + y * dimension) of a uint64 is
+// set when the light at (x, y) is on, so a press is a few shifts, masks and
+// an XOR on a single word. Which lights a press toggles is up to the Rules,
+// which default to the classic plus shape.
+
+class Grid
+{
+public:
+	Grid(int8 dimension);
+	void SetDimension(int8 dimension);
+	int8 Dimension() const { return fDimension; }
+	void SetRules(const Rules& rules);
+	const Rules& GetRules() const { return fRules; }
+	void Random(int8 minMoves,
+		RandomGenerator& generator = RandomGenerator::ForThread());
+	uint64 Press(int8 offset);
+	void FlipValueAt(int8 x, int8 y);
+	void FlipValueAt(int8 offset);
+	bool ValueAt(int8 x, int8 y);
+	bool ValueAt(int8 offset);
+	void SetValue(int8 offset, bool isOn);
+	void SetValue(int8 x, int8 y, bool isOn);
+	void SetGridValues(uint64 value);
+	uint64 GetGridValues() const;
+
+	static uint64 PressMask(int8 dimension, int8 offset);
+	static uint64 FullMask(int8 dimension);
+
+	// the murmur3 finaliser, which spreads every bit of a board over the
+	// whole word, for hash tables of boards
+	static uint64 HashBoard(uint64 board)
+	{
+		board ^= board >> 33;
+		board *= 0xff51afd7ed558ccdULL;
+		return board ^ board >> 33;
+	}
+
+private:
+	int8 fDimension;
+	uint64 fData;
+	rule_geometry fGeometry;
+	Rules fRules;
+	bool fClassic;
+};
+
+#endif
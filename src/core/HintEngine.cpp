@@ -0,0 +1,124 @@
+#include "HintEngine.h"
+
+#include <string.h>
+
+#include "Grid.h"
+#include "Solver.h"
+
+
+HintEngine::HintEngine()
+	:
+	fSolver(NULL)
+{
+	Grid grid(1);
+	Start(grid);
+}
+
+/*
+ * Solve the board on grid, under its rules, as the puzzle to give hints for.
+ */
+
+void HintEngine::Start(const Grid& grid)
+{
+	if (fSolver == NULL || grid.Dimension() != fSolver->Dimension()
+		|| grid.GetRules() != fSolver->GetRules()) {
+		fSolver = &Solver::ForDimension(grid.Dimension(), grid.GetRules());
+		_SetColumns();
+	}
+
+	SetBoard(grid.GetGridValues());
+}
+
+/*
+ * Solve board from scratch, for when the grid has changed by more than a
+ * press or a flip since the last one.
+ */
+
+void HintEngine::SetBoard(uint64 board)
+{
+	// the board is the sum of its lights, each flipped on from nothing
+	fPresses = 0;
+	fFailedChecks = 0;
+
+	for (; board != 0; board &= board - 1) {
+		const int32 light = __builtin_ctzll(board);
+		fPresses ^= fInverseColumns[light];
+		fFailedChecks ^= fCheckColumns[light];
+	}
+
+	fIsHintValid = false;
+}
+
+int32 HintEngine::Nullity() const
+{
+	return fSolver->Nullity();
+}
+
+/*
+ * The fewest presses that turn off every light, or 0 if the board can't be
+ * solved.
+ */
+
+uint64 HintEngine::Hint()
+{
+	if (!IsSolvable())
+		return 0;
+
+	if (!fIsHintValid) {
+		fHint = fSolver->Minimize(fPresses);
+		fIsHintValid = true;
+	}
+
+	return fHint;
+}
+
+/*
+ * A button that is part of the hint, or -1 if there is none to press.
+ */
+
+int8 HintEngine::NextPress()
+{
+	const uint64 hint = Hint();
+	if (hint == 0)
+		return -1;
+
+	return __builtin_ctzll(hint);
+}
+
+/*
+ * The number of presses in the hint, or -1 if the board can't be solved.
+ */
+
+int32 HintEngine::MovesRemaining()
+{
+	if (!IsSolvable())
+		return -1;
+
+	return CountBits(Hint());
+}
+
+/*
+ * Turn the rows of the solver's pseudo-inverse and checks into what each
+ * light contributes to the presses and to the checks.
+ */
+
+void HintEngine::_SetColumns()
+{
+	const int32 numCells = fSolver->Dimension() * fSolver->Dimension();
+	const int32 numChecks = fSolver->NumChecks();
+
+	memset(fInverseColumns, 0, sizeof(fInverseColumns));
+	memset(fCheckColumns, 0, sizeof(fCheckColumns));
+
+	for (int32 light = 0; light < numCells; light++) {
+		for (int32 index = 0; index < numCells; index++) {
+			fInverseColumns[light]
+				|= ((*fSolver->InverseRow(index) >> light) & 1) << index;
+		}
+
+		for (int32 index = 0; index < numChecks; index++) {
+			fCheckColumns[light]
+				|= ((*fSolver->CheckRow(index) >> light) & 1) << index;
+		}
+	}
+}
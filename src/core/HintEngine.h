@@ -0,0 +1,75 @@
+#ifndef HINT_ENGINE_H
+#define HINT_ENGINE_H
+
+#include "CoreDefs.h"
+#include "Rules.h"
+
+class Grid;
+class Solver;
+
+// The HintEngine class keeps an optimal solution of the puzzle being played
+// at hand, so the player can be shown what to press next and how many moves
+// are left without solving the board again after every move.
+//
+// Pressing is linear over GF(2): if the presses x turn off board b, then
+// after pressing button j the presses x with bit j flipped turn off what is
+// left. So Start() solves the board once, with the pseudo-inverse of the
+// Solver for the dimension and the rules, and each Press() after that is a
+// single XOR. When the press matrix is singular, the solutions of a board
+// are x plus any combination of its null space, and Hint() has
+// Solver::Minimize() pick the lightest of them; the result is kept until the
+// board changes again.
+//
+// Flipping a single light is just as cheap: the presses change by the
+// column of the pseudo-inverse for that light, and whether the board can
+// still be solved by the column of the checks, so FlipValueAt() is two XORs
+// of columns worked out when the solver changes. Jumps that aren't one
+// press or flip, like a restart, go through SetBoard(), which does the same
+// for every light that is on.
+
+class HintEngine
+{
+public:
+	HintEngine();
+
+	void Start(const Grid& grid);
+	void SetBoard(uint64 board);
+
+	void Press(int8 button)
+	{
+		fPresses ^= (uint64) 1 << button;
+		fIsHintValid = false;
+	}
+
+	void FlipValueAt(int8 offset)
+	{
+		fPresses ^= fInverseColumns[offset];
+		fFailedChecks ^= fCheckColumns[offset];
+		fIsHintValid = false;
+	}
+
+	bool IsSolvable() const { return fFailedChecks == 0; }
+	int32 Nullity() const;
+
+	uint64 Hint();
+	int8 NextPress();
+	int32 MovesRemaining();
+
+private:
+	void _SetColumns();
+
+	const Solver* fSolver;
+
+	// the pseudo-inverse applied to the board, and one bit per check that
+	// it fails
+	uint64 fPresses;
+	uint64 fFailedChecks;
+	uint64 fHint;
+	bool fIsHintValid;
+
+	// what flipping each light does to fPresses and fFailedChecks
+	uint64 fInverseColumns[64];
+	uint64 fCheckColumns[64];
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+MappedFile::MappedFile()
+	:
+	fFD(-1),
+	fFileSize(0),
+	fMapping(NULL),
+	fSize(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+/*
+ * Open the file at path and read headerSize bytes from its start into
+ * header. Files shorter than minSize are rejected right away.
+ */
+
+status_t MappedFile::ReadHeader(const char* path, void* header,
+	size_t headerSize, size_t minSize)
+{
+	Close();
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return B_FROM_POSIX_ERROR(errno);
+
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		status_t status = B_FROM_POSIX_ERROR(errno);
+		close(fd);
+		return status;
+	}
+
+	if ((uint64) info.st_size < minSize || (uint64) info.st_size < headerSize
+		|| pread(fd, header, headerSize, 0) != (ssize_t) headerSize) {
+		close(fd);
+		return B_BAD_DATA;
+	}
+
+	fFD = fd;
+	fFileSize = info.st_size;
+
+	return B_OK;
+}
+
+/*
+ * Map the first size bytes of the file ReadHeader() opened. Lookups that
+ * jump all over the file should pass randomAccess, as reading ahead would
+ * only waste memory then.
+ */
+
+status_t MappedFile::Map(size_t size, bool randomAccess)
+{
+	if (fFD < 0)
+		return B_NO_INIT;
+	if (size > fFileSize) {
+		Close();
+		return B_BAD_DATA;
+	}
+
+	void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fFD, 0);
+	status_t status
+		= mapping != MAP_FAILED ? B_OK : B_FROM_POSIX_ERROR(errno);
+
+	// the mapping keeps the file open
+	close(fFD);
+	fFD = -1;
+
+	if (status != B_OK) {
+		Close();
+		return status;
+	}
+
+	if (randomAccess)
+		madvise(mapping, size, MADV_RANDOM);
+
+	fMapping = mapping;
+	fSize = size;
+
+	return B_OK;
+}
+
+void MappedFile::Close()
+{
+	if (fFD >= 0)
+		close(fFD);
+	if (fMapping != NULL)
+		munmap(fMapping, fSize);
+
+	fFD = -1;
+	fFileSize = 0;
+	fMapping = NULL;
+	fSize = 0;
+}
+
+/*
+ * The FNV-1a hash of data, continuing from hash for data that comes in
+ * pieces.
+ */
+
+uint64 MappedFile::Checksum(const uint8* data, size_t size, uint64 hash)
+{
+	for (size_t index = 0; index < size; index++) {
+		hash ^= data[index];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
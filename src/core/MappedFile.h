@@ -0,0 +1,46 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include "CoreDefs.h"
+
+// The MappedFile class maps a file that starts with a fixed-size header
+// read-only, for the file formats that are looked up in place rather than
+// read in (DistanceDatabase and PuzzlePack). Opening takes two steps, so the
+// format can check its header in between: ReadHeader() opens the file and
+// reads the header from its start, and Map() then maps as much of the file
+// as the header says there is. The file is closed again once it is mapped,
+// or when Close() is called instead.
+//
+// Checksum() is the FNV-1a hash both formats store in their header.
+
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	status_t ReadHeader(const char* path, void* header, size_t headerSize,
+		size_t minSize);
+	status_t Map(size_t size, bool randomAccess = false);
+	void Close();
+
+	uint64 FileSize() const { return fFileSize; }
+	const uint8* Data() const { return (const uint8*) fMapping; }
+	size_t Size() const { return fSize; }
+
+	static const uint64 kChecksumStart = 0xcbf29ce484222325ULL;
+
+	static uint64 Checksum(const uint8* data, size_t size,
+		uint64 hash = kChecksumStart);
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	int fFD;
+	uint64 fFileSize;
+	void* fMapping;
+	size_t fSize;
+};
+
+#endif
@@ -0,0 +1,229 @@
+#include "ModularBoard.h"
+
+#include <assert.h>
+#include <string.h>
+
+
+// a word with the low bit of every lane of the given width set
+static uint64
+LaneOnes(int32 width)
+{
+	uint64 ones = 0;
+	for (int32 bit = 0; bit < 64; bit += width)
+		ones |= (uint64) 1 << bit;
+
+	return ones;
+}
+
+
+ModularBoard::ModularBoard(int8 dimension, int8 numStates,
+	neighbourhood shape, bool toroidal)
+	:
+	fDimension(dimension),
+	fNumStates(numStates),
+	fBits(numStates <= 4 ? 2 : 4),
+	fShape(shape),
+	fToroidal(toroidal)
+{
+	assert(numStates >= 2 && numStates <= kMaxStates);
+	assert(dimension > 0 && dimension <= MaxDimension(numStates));
+	assert(!toroidal || dimension >= 3);
+
+	const int32 rowBits = dimension * fBits;
+	const uint64 rowMask
+		= rowBits >= 64 ? ~(uint64) 0 : ((uint64) 1 << rowBits) - 1;
+
+	fLightMask = ((uint64) 1 << fBits) - 1;
+
+	fLanes.bits = fBits;
+	fLanes.numStates = numStates;
+	fLanes.lastShift = rowBits - fBits;
+	fLanes.toroidal = toroidal;
+	fLanes.lightMask = fLightMask;
+	fLanes.evenLanes = LaneOnes(2 * fBits) * fLightMask & rowMask;
+	fLanes.lastLane = fLightMask << fLanes.lastShift;
+
+	// a double lane holds 2 * bits bits, and its top bit is set exactly
+	// when the sum of two values below k plus the bias is at least k
+	const uint64 doubleOnes = LaneOnes(2 * fBits);
+	fLanes.halfBias
+		= doubleOnes * (((uint64) 1 << (2 * fBits - 1)) - numStates);
+	fLanes.halfTop = doubleOnes << (2 * fBits - 1);
+
+	Clear();
+}
+
+/*
+ * The widest board that fits a row in a word for k states.
+ */
+
+int8 ModularBoard::MaxDimension(int8 numStates)
+{
+	return numStates <= 4 ? 32 : 16;
+}
+
+void ModularBoard::SetValue(int8 x, int8 y, int8 value)
+{
+	assert(value >= 0 && value < fNumStates);
+
+	const int32 shift = x * fBits;
+	fRows[y] = (fRows[y] & ~(fLightMask << shift)) | (uint64) value << shift;
+}
+
+void ModularBoard::Press(int8 x, int8 y, int8 times)
+{
+	ModularBoard presses(fDimension, fNumStates, fShape, fToroidal);
+	presses.SetValue(x, y, times % fNumStates);
+
+	PressAll(presses);
+}
+
+/*
+ * Press every button as often as its value in presses says.
+ */
+
+void ModularBoard::PressAll(const ModularBoard& presses)
+{
+	assert(presses.fDimension == fDimension);
+	assert(presses.fNumStates == fNumStates);
+
+	const lanes lanes = fLanes;
+	const int8 n = fDimension;
+	uint64 vertical[kMaxDimension];
+
+	// what each row gets from the rows above and below it
+	for (int8 y = 0; y < n; y++) {
+		uint64 sum = 0;
+
+		if (y > 0)
+			sum = presses.fRows[y - 1];
+		else if (fToroidal)
+			sum = presses.fRows[n - 1];
+
+		if (y < n - 1)
+			sum = lanes.Add(sum, presses.fRows[y + 1]);
+		else if (fToroidal)
+			sum = lanes.Add(sum, presses.fRows[0]);
+
+		vertical[y] = sum;
+	}
+
+	for (int8 y = 0; y < n; y++) {
+		const uint64 row = presses.fRows[y];
+		uint64 toggled = row;
+
+		if (fShape != kXNeighbourhood) {
+			toggled = lanes.Add(toggled, vertical[y]);
+			toggled = lanes.Add(toggled,
+				lanes.Add(lanes.East(row), lanes.West(row)));
+		}
+
+		if (fShape != kPlusNeighbourhood) {
+			toggled = lanes.Add(toggled,
+				lanes.Add(lanes.East(vertical[y]), lanes.West(vertical[y])));
+		}
+
+		fRows[y] = lanes.Add(fRows[y], toggled);
+	}
+}
+
+void ModularBoard::Clear()
+{
+	memset(fRows, 0, sizeof(fRows));
+}
+
+bool ModularBoard::IsZero() const
+{
+	uint64 any = 0;
+	for (int8 y = 0; y < fDimension; y++)
+		any |= fRows[y];
+
+	return any == 0;
+}
+
+/*
+ * The sum of all values, which for a board of press counts is the number of
+ * presses.
+ */
+
+int32 ModularBoard::Sum() const
+{
+	int32 sum = 0;
+	for (int8 y = 0; y < fDimension; y++)
+		for (uint64 row = fRows[y]; row != 0; row >>= fBits)
+			sum += row & fLightMask;
+
+	return sum;
+}
+
+ModularBoard& ModularBoard::operator+=(const ModularBoard& other)
+{
+	assert(other.fDimension == fDimension);
+	assert(other.fNumStates == fNumStates);
+
+	const lanes lanes = fLanes;
+	for (int8 y = 0; y < fDimension; y++)
+		fRows[y] = lanes.Add(fRows[y], other.fRows[y]);
+
+	return *this;
+}
+
+bool ModularBoard::operator==(const ModularBoard& other) const
+{
+	if (other.fDimension != fDimension || other.fNumStates != fNumStates)
+		return false;
+
+	uint64 difference = 0;
+	for (int8 y = 0; y < fDimension; y++)
+		difference |= fRows[y] ^ other.fRows[y];
+
+	return difference == 0;
+}
+
+/*
+ * Add two rows lane by lane, mod k.
+ */
+
+uint64 ModularBoard::lanes::Add(uint64 a, uint64 b) const
+{
+	const uint64 even = AddHalf(a & evenLanes, b & evenLanes);
+	const uint64 odd = AddHalf(a >> bits & evenLanes, b >> bits & evenLanes);
+
+	return even | odd << bits;
+}
+
+/*
+ * Add every other lane, mod k. The lanes in between are empty, so each sum
+ * has twice the bits of a lane to itself and never carries into the next.
+ */
+
+uint64 ModularBoard::lanes::AddHalf(uint64 a, uint64 b) const
+{
+	const uint64 sum = a + b;
+	const uint64 wrapped = ((sum + halfBias) & halfTop) >> (2 * bits - 1);
+
+	return sum - wrapped * numStates;
+}
+
+/*
+ * Every light moved one lane to the right or left; lights that leave the
+ * row are dropped or, on a torus, come back in at the other end.
+ */
+
+uint64 ModularBoard::lanes::East(uint64 row) const
+{
+	uint64 moved = (row & ~lastLane) << bits;
+	if (toroidal)
+		moved |= (row & lastLane) >> lastShift;
+
+	return moved;
+}
+
+uint64 ModularBoard::lanes::West(uint64 row) const
+{
+	uint64 moved = row >> bits;
+	if (toroidal)
+		moved |= (row & lightMask) << lastShift;
+
+	return moved;
+}
@@ -0,0 +1,98 @@
+#ifndef MODULAR_BOARD_H
+#define MODULAR_BOARD_H
+
+#include "CoreDefs.h"
+#include "Rules.h"
+
+// The ModularBoard class holds a board whose lights cycle through k states
+// (2 <= k <= 16) instead of being on or off: a press moves every light it
+// touches on to its next state, and the puzzle is solved when all of them
+// are back at 0.
+//
+// Like Board, it keeps one word per row, but each light is a lane of 2 bits
+// (k <= 4) or 4 bits (k <= 16) in that word, so rows are up to 32 or 16
+// lights wide. Adding two rows mod k is done on all lanes of the word at
+// once: every other lane is masked out, which leaves each remaining lane an
+// empty neighbour to carry into, the lanes are added with a single integer
+// addition, and those that reached k get k taken off again. Pressing a whole
+// set of buttons is then a handful of such additions per row, one for each
+// neighbour direction, with the press counts shifted by one lane for left
+// and right.
+
+class ModularBoard
+{
+public:
+	enum {
+		kMaxDimension = 32,
+		kMaxStates = 16
+	};
+
+	ModularBoard(int8 dimension = 1, int8 numStates = 3,
+		neighbourhood shape = kPlusNeighbourhood, bool toroidal = false);
+
+	static int8 MaxDimension(int8 numStates);
+
+	int8 Dimension() const { return fDimension; }
+	int32 CountButtons() const { return fDimension * fDimension; }
+	int8 NumStates() const { return fNumStates; }
+	int8 BitsPerLight() const { return fBits; }
+	neighbourhood Shape() const { return fShape; }
+	bool IsToroidal() const { return fToroidal; }
+
+	uint64 Row(int8 y) const { return fRows[y]; }
+
+	int8 ValueAt(int8 x, int8 y) const
+		{ return (fRows[y] >> (x * fBits)) & fLightMask; }
+	int8 ValueAt(int32 offset) const
+		{ return ValueAt(offset % fDimension, offset / fDimension); }
+	void SetValue(int8 x, int8 y, int8 value);
+	void SetValue(int32 offset, int8 value)
+		{ SetValue(offset % fDimension, offset / fDimension, value); }
+
+	void Press(int8 x, int8 y, int8 times = 1);
+	void Press(int32 offset, int8 times = 1)
+		{ Press(offset % fDimension, offset / fDimension, times); }
+	void PressAll(const ModularBoard& presses);
+
+	void Clear();
+	bool IsZero() const;
+	int32 Sum() const;
+
+	ModularBoard& operator+=(const ModularBoard& other);
+	bool operator==(const ModularBoard& other) const;
+	bool operator!=(const ModularBoard& other) const
+		{ return !(*this == other); }
+
+private:
+	// The constants of the lane arithmetic. The loops over the rows work on
+	// a local copy, as the compiler would otherwise have to reload them
+	// after every row written.
+	struct lanes {
+		uint64 Add(uint64 a, uint64 b) const;
+		uint64 AddHalf(uint64 a, uint64 b) const;
+		uint64 East(uint64 row) const;
+		uint64 West(uint64 row) const;
+
+		int32	bits;
+		int32	numStates;
+		int32	lastShift;		// from the leftmost to the rightmost lane
+		bool	toroidal;
+		uint64	lightMask;		// one lane
+		uint64	evenLanes;		// lanes 0, 2, 4, ... of a row
+		uint64	lastLane;		// the rightmost light of a row
+		uint64	halfBias;		// 2^(2 * bits - 1) - k in every double lane
+		uint64	halfTop;		// the top bit of every double lane
+	};
+
+	int8 fDimension;
+	int8 fNumStates;
+	int8 fBits;
+	neighbourhood fShape;
+	bool fToroidal;
+	uint64 fLightMask;
+	lanes fLanes;
+
+	uint64 fRows[kMaxDimension];
+};
+
+#endif
@@ -0,0 +1,320 @@
+#include "ModularSolver.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "ModularBoard.h"
+
+
+static int32
+GreatestCommonDivisor(int32 a, int32 b)
+{
+	while (b != 0) {
+		const int32 rest = a % b;
+		a = b;
+		b = rest;
+	}
+
+	return a;
+}
+
+
+/*
+ * Find s and t with s * a + t * b = gcd(a, b), which is returned.
+ */
+
+static int32
+ExtendedEuclid(int32 a, int32 b, int32& s, int32& t)
+{
+	int32 s0 = 1, t0 = 0;
+	int32 s1 = 0, t1 = 1;
+
+	while (b != 0) {
+		const int32 quotient = a / b;
+		int32 rest = a - quotient * b;
+		a = b;
+		b = rest;
+
+		rest = s0 - quotient * s1;
+		s0 = s1;
+		s1 = rest;
+
+		rest = t0 - quotient * t1;
+		t0 = t1;
+		t1 = rest;
+	}
+
+	s = s0;
+	t = t0;
+	return a;
+}
+
+
+ModularSolver::ModularSolver(int8 dimension, int8 numStates,
+	neighbourhood shape, bool toroidal)
+	:
+	fDimension(dimension),
+	fNumStates(numStates),
+	fShape(shape),
+	fToroidal(toroidal),
+	fNumButtons(dimension * dimension),
+	fStride(2 * dimension * dimension),
+	fNumRows(0),
+	fRank(0)
+{
+	assert(numStates >= 2 && numStates <= ModularBoard::kMaxStates);
+	assert(dimension > 0 && dimension <= ModularBoard::MaxDimension(numStates));
+
+	for (int32 a = 0; a < numStates; a++)
+		for (int32 b = 0; b < numStates; b++)
+			fProducts[a][b] = a * b % numStates;
+
+	// row i of [A | I]: which buttons move light i, and the unit vector
+	std::vector<std::vector<uint8> > columns(fNumButtons);
+	for (int32 button = 0; button < fNumButtons; button++) {
+		ModularBoard board(dimension, numStates, shape, toroidal);
+		board.Press(button);
+
+		for (int32 light = 0; light < fNumButtons; light++)
+			columns[button].push_back(board.ValueAt(light));
+	}
+
+	std::vector<uint8> row(fStride);
+	for (int32 light = 0; light < fNumButtons; light++) {
+		memset(&row[0], 0, fStride);
+
+		for (int32 button = 0; button < fNumButtons; button++)
+			row[button] = columns[button][light];
+		row[fNumButtons + light] = 1;
+
+		_AddRow(&row[0]);
+	}
+
+	_Eliminate();
+}
+
+/*
+ * Find press counts that turn every light off. Returns false if there are
+ * none.
+ */
+
+bool ModularSolver::Solve(const ModularBoard& lights,
+	ModularBoard& presses) const
+{
+	std::vector<uint8> transformed;
+	if (!_Transform(lights, transformed))
+		return false;
+
+	std::vector<uint8> counts(fNumButtons, 0);
+
+	for (int32 row = fRank - 1; row >= 0; row--) {
+		const uint8* values = _Row(row);
+		const int32 pivotColumn = fPivotColumns[row];
+		int32 rest = transformed[row];
+
+		for (int32 column = pivotColumn + 1; column < fNumButtons; column++) {
+			rest += fNumStates - fProducts[values[column]][counts[column]];
+			if (rest >= fNumStates)
+				rest -= fNumStates;
+		}
+
+		// the pivot divides k, and the Howell form makes it divide this too
+		// whenever the board can be solved
+		const int32 pivot = values[pivotColumn];
+		if (rest % pivot != 0)
+			return false;
+
+		counts[pivotColumn] = rest / pivot;
+	}
+
+	presses = ModularBoard(fDimension, fNumStates, fShape, fToroidal);
+	for (int32 button = 0; button < fNumButtons; button++)
+		presses.SetValue(button, counts[button]);
+
+	return true;
+}
+
+bool ModularSolver::IsSolvable(const ModularBoard& lights) const
+{
+	ModularBoard presses;
+	return Solve(lights, presses);
+}
+
+/*
+ * Reduce [A | I] to Howell form, column by column.
+ */
+
+void ModularSolver::_Eliminate()
+{
+	for (int32 column = 0; column < fNumButtons && fRank < fNumRows;
+			column++) {
+		// start with the entry that has the fewest factors in common with k,
+		// ideally a unit
+		int32 best = -1;
+		int32 bestDivisor = fNumStates;
+
+		for (int32 row = fRank; row < fNumRows; row++) {
+			const int32 value = _Row(row)[column];
+			if (value == 0)
+				continue;
+
+			const int32 divisor = GreatestCommonDivisor(value, fNumStates);
+			if (divisor < bestDivisor) {
+				best = row;
+				bestDivisor = divisor;
+				if (divisor == 1)
+					break;
+			}
+		}
+
+		if (best < 0)
+			continue;
+
+		if (best != fRank) {
+			std::vector<uint8> swap(_Row(best), _Row(best) + fStride);
+			memcpy(_Row(best), _Row(fRank), fStride);
+			memcpy(_Row(fRank), &swap[0], fStride);
+		}
+
+		// clear the column below the pivot
+		for (int32 row = fRank + 1; row < fNumRows; row++) {
+			const int32 value = _Row(row)[column];
+			if (value == 0)
+				continue;
+
+			const int32 pivot = _Row(fRank)[column];
+
+			if (GreatestCommonDivisor(pivot, fNumStates) == 1) {
+				int32 inverse = 1;
+				while (fProducts[pivot][inverse] != 1)
+					inverse++;
+
+				// row -= (value / pivot) * pivot row
+				_CombineRows(row, fRank, 1,
+					fNumStates - fProducts[value][inverse]);
+				continue;
+			}
+
+			// the pivot becomes gcd(pivot, value), and the row
+			// (value / g) * pivot row - (pivot / g) * row, which is zero in
+			// this column; the transformation has determinant -1, so it can
+			// be undone
+			int32 s, t;
+			const int32 divisor = ExtendedEuclid(pivot, value, s, t);
+			const int32 pivotFactor = value / divisor;
+			const int32 rowFactor = fNumStates - pivot / divisor;
+
+			std::vector<uint8> pivotRow(_Row(fRank), _Row(fRank) + fStride);
+			_CombineRows(fRank, row, (s % fNumStates + fNumStates) % fNumStates,
+				(t % fNumStates + fNumStates) % fNumStates);
+
+			uint8* values = _Row(row);
+			for (int32 index = 0; index < fStride; index++) {
+				int32 sum = fProducts[pivotFactor][pivotRow[index]]
+					+ fProducts[rowFactor][values[index]];
+				values[index] = sum % fNumStates;
+			}
+		}
+
+		// make the pivot the divisor of k it is a unit multiple of
+		const int32 pivot = _Row(fRank)[column];
+		const int32 divisor = GreatestCommonDivisor(pivot, fNumStates);
+
+		for (int32 unit = 1; unit < fNumStates; unit++) {
+			if (fProducts[pivot][unit] == divisor
+				&& GreatestCommonDivisor(unit, fNumStates) == 1) {
+				_ScaleRow(fRank, unit);
+				break;
+			}
+		}
+
+		// (k / g) times the pivot row vanishes in this column but not
+		// necessarily in the others, where it has to be taken into account
+		if (divisor != 1) {
+			std::vector<uint8> extra(_Row(fRank), _Row(fRank) + fStride);
+			for (int32 index = 0; index < fStride; index++)
+				extra[index] = fProducts[fNumStates / divisor][extra[index]];
+
+			bool isZero = true;
+			for (int32 index = 0; index < fStride; index++)
+				isZero = isZero && extra[index] == 0;
+
+			if (!isZero)
+				_AddRow(&extra[0]);
+		}
+
+		fPivotColumns.push_back(column);
+		fRank++;
+	}
+}
+
+/*
+ * target = targetFactor * target + sourceFactor * source, with both factors
+ * already reduced mod k.
+ */
+
+void ModularSolver::_CombineRows(int32 target, int32 source,
+	int32 targetFactor, int32 sourceFactor)
+{
+	uint8* targetValues = _Row(target);
+	const uint8* sourceValues = _Row(source);
+	const uint8* targetProducts = fProducts[targetFactor];
+	const uint8* sourceProducts = fProducts[sourceFactor];
+
+	for (int32 index = 0; index < fStride; index++) {
+		int32 sum = targetProducts[targetValues[index]]
+			+ sourceProducts[sourceValues[index]];
+		if (sum >= fNumStates)
+			sum -= fNumStates;
+
+		targetValues[index] = sum;
+	}
+}
+
+void ModularSolver::_ScaleRow(int32 row, int32 factor)
+{
+	uint8* values = _Row(row);
+	for (int32 index = 0; index < fStride; index++)
+		values[index] = fProducts[factor][values[index]];
+}
+
+void ModularSolver::_AddRow(const uint8* values)
+{
+	fMatrix.insert(fMatrix.end(), values, values + fStride);
+	fNumRows++;
+}
+
+/*
+ * Apply the row transform U to -b. Rows past the pivots are zero in H, so
+ * they must come out zero here as well or the board can't be solved.
+ */
+
+bool ModularSolver::_Transform(const ModularBoard& lights,
+	std::vector<uint8>& transformed) const
+{
+	assert(lights.Dimension() == fDimension);
+	assert(lights.NumStates() == fNumStates);
+
+	std::vector<uint8> negated(fNumButtons);
+	for (int32 light = 0; light < fNumButtons; light++) {
+		const int32 value = lights.ValueAt(light);
+		negated[light] = value == 0 ? 0 : fNumStates - value;
+	}
+
+	transformed.resize(fNumRows);
+
+	for (int32 row = 0; row < fNumRows; row++) {
+		const uint8* transform = _Row(row) + fNumButtons;
+		int32 sum = 0;
+
+		for (int32 light = 0; light < fNumButtons; light++)
+			sum += fProducts[transform[light]][negated[light]];
+
+		transformed[row] = sum % fNumStates;
+
+		if (row >= fRank && transformed[row] != 0)
+			return false;
+	}
+
+	return true;
+}
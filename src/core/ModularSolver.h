@@ -0,0 +1,75 @@
+#ifndef MODULAR_SOLVER_H
+#define MODULAR_SOLVER_H
+
+#include <vector>
+
+#include "CoreDefs.h"
+#include "Rules.h"
+
+class ModularBoard;
+
+// The ModularSolver class solves boards of lights with k states, the
+// ModularBoard counterpart of Solver. Pressing is linear over Z_k: a board b
+// is solved by any vector of press counts x with A x = -b (mod k), where
+// column j of the press matrix A holds the lights that button j moves on.
+//
+// For prime k, Z_k is a field and this is ordinary Gaussian elimination.
+// Otherwise some nonzero entries have no inverse, and a pivot can only be
+// made a divisor g of k. The elimination then brings [A | I] into Howell
+// form: the gcd of a column is collected into the pivot row with extended
+// Euclid row operations, and (k / g) times the pivot row, which has a zero
+// in the pivot column but may constrain the later ones, is added as one
+// more row. In that form any choice for the press count of one button still
+// allows a solution for those before it, so solving is a matrix-vector
+// product followed by back-substitution, with no backtracking.
+//
+// Like Solver, the reduction is done once in the constructor; the press
+// matrix is banded, so even 32x32 takes less than 100 ms, and a solve is a
+// few ms after that. The solution returned is one of possibly many, not
+// necessarily the one with the fewest presses.
+
+class ModularSolver
+{
+public:
+	ModularSolver(int8 dimension, int8 numStates,
+		neighbourhood shape = kPlusNeighbourhood, bool toroidal = false);
+
+	int8 Dimension() const { return fDimension; }
+	int8 NumStates() const { return fNumStates; }
+	int32 Rank() const { return fRank; }
+
+	bool Solve(const ModularBoard& lights, ModularBoard& presses) const;
+	bool IsSolvable(const ModularBoard& lights) const;
+
+private:
+	void _Eliminate();
+	void _CombineRows(int32 target, int32 source, int32 targetFactor,
+		int32 sourceFactor);
+	void _ScaleRow(int32 row, int32 factor);
+	void _AddRow(const uint8* values);
+	bool _Transform(const ModularBoard& lights,
+		std::vector<uint8>& transformed) const;
+
+	uint8* _Row(int32 row) { return &fMatrix[row * fStride]; }
+	const uint8* _Row(int32 row) const { return &fMatrix[row * fStride]; }
+
+	int8 fDimension;
+	int8 fNumStates;
+	neighbourhood fShape;
+	bool fToroidal;
+	int32 fNumButtons;
+	int32 fStride;
+	int32 fNumRows;
+	int32 fRank;
+
+	// [H | U] with H = U A in Howell form, one row of 2 * fNumButtons
+	// entries per equation; the first fRank rows have a pivot, the column of
+	// which is in fPivotColumns
+	std::vector<uint8> fMatrix;
+	std::vector<int32> fPivotColumns;
+
+	// (a * b) mod k for all a, b < k
+	uint8 fProducts[16][16];
+};
+
+#endif
@@ -0,0 +1,288 @@
+#include "MoveHistory.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "Grid.h"
+
+
+MoveHistory::MoveHistory()
+{
+	Grid grid(1);
+	Start(grid);
+}
+
+/*
+ * Forget everything and start over from the board on grid, which is also
+ * where the press masks come from.
+ */
+
+void MoveHistory::Start(const Grid& grid)
+{
+	const int8 dimension = grid.Dimension();
+	const Rules& rules = grid.GetRules();
+
+	memset(fPressMasks, 0, sizeof(fPressMasks));
+	for (int8 offset = 0; offset < dimension * dimension; offset++)
+		fPressMasks[offset] = rules.PressMask(dimension, offset);
+
+	fFreeNodes = kNoNode;
+	for (int32 index = kCapacity - 1; index >= 0; index--)
+		_FreeNode(index);
+
+	const int16 root = _AllocateNode();
+	fNodes[root].button = 0;
+
+	fBoard = grid.GetGridValues();
+	fFirst = fPosition = fLength = 0;
+	fPath[0] = root;
+	fCheckpoints[0] = fBoard;
+}
+
+/*
+ * Play button at the current position. If it was played from here before,
+ * the line goes back to that branch, otherwise a new one is started.
+ */
+
+void MoveHistory::Press(int8 button)
+{
+	const int16 current = _NodeAt(fPosition);
+
+	for (int16 child = fNodes[current].firstChild; child != kNoNode;
+			child = fNodes[child].nextSibling) {
+		if (fNodes[child].button == button) {
+			_SelectChild(child);
+			return;
+		}
+	}
+
+	// making room may cut the line short, but never before fPosition
+	const int16 child = _AllocateNode();
+
+	fNodes[child].nextSibling = fNodes[current].firstChild;
+	fNodes[child].button = button;
+	fNodes[current].firstChild = child;
+
+	_SelectChild(child);
+}
+
+/*
+ * Press button, unless it was the last one pressed, in which case that
+ * press is taken back instead. Returns true if it was.
+ */
+
+bool MoveHistory::PressOrUndo(int8 button)
+{
+	if (fPosition > fFirst && MoveAt(fPosition - 1) == button) {
+		Undo();
+		return true;
+	}
+
+	Press(button);
+	return false;
+}
+
+bool MoveHistory::Undo()
+{
+	if (fPosition == fFirst)
+		return false;
+
+	fBoard ^= _MaskAt(fPosition);
+	fPosition--;
+	return true;
+}
+
+bool MoveHistory::Redo()
+{
+	if (fPosition == fLength)
+		return false;
+
+	fPosition++;
+	fBoard ^= _MaskAt(fPosition);
+	return true;
+}
+
+void MoveHistory::Seek(int32 position)
+{
+	fBoard = BoardAt(position);
+	fPosition = position;
+}
+
+/*
+ * Make the next or previous of the moves played from the current position
+ * the one that is redone, along with everything played after it.
+ */
+
+bool MoveHistory::NextBranch()
+{
+	node& current = fNodes[_NodeAt(fPosition)];
+	if (current.redo == kNoNode)
+		return false;
+
+	int16 next = fNodes[current.redo].nextSibling;
+	if (next == kNoNode)
+		next = current.firstChild;
+	if (next == current.redo)
+		return false;
+
+	current.redo = next;
+	_ExtendLine(fPosition);
+	return true;
+}
+
+bool MoveHistory::PreviousBranch()
+{
+	node& current = fNodes[_NodeAt(fPosition)];
+	if (current.redo == kNoNode)
+		return false;
+
+	// the sibling before redo, or the last one if redo is the first
+	int16 previous = current.firstChild;
+	while (fNodes[previous].nextSibling != current.redo
+		&& fNodes[previous].nextSibling != kNoNode)
+		previous = fNodes[previous].nextSibling;
+
+	if (previous == current.redo)
+		return false;
+
+	current.redo = previous;
+	_ExtendLine(fPosition);
+	return true;
+}
+
+int32 MoveHistory::CountBranches() const
+{
+	int32 count = 0;
+	for (int16 child = fNodes[_NodeAt(fPosition)].firstChild;
+			child != kNoNode; child = fNodes[child].nextSibling)
+		count++;
+
+	return count;
+}
+
+/*
+ * The move played from position, that is the button pressed to get to
+ * position + 1.
+ */
+
+int8 MoveHistory::MoveAt(int32 position) const
+{
+	assert(position >= fFirst && position < fLength);
+
+	return fNodes[_NodeAt(position + 1)].button;
+}
+
+uint64 MoveHistory::BoardAt(int32 position) const
+{
+	assert(position >= fFirst && position <= fLength);
+
+	int32 at = position - position % kCheckpointInterval;
+	uint64 board = fCheckpoints[_CheckpointIndex(at)];
+
+	while (at < position)
+		board ^= _MaskAt(++at);
+
+	return board;
+}
+
+void MoveHistory::_SelectChild(int16 child)
+{
+	node& current = fNodes[_NodeAt(fPosition)];
+
+	if (current.redo != child) {
+		current.redo = child;
+		_ExtendLine(fPosition);
+	}
+
+	Redo();
+}
+
+/*
+ * Rebuild the line after position by following the redo links.
+ */
+
+void MoveHistory::_ExtendLine(int32 position)
+{
+	uint64 board = BoardAt(position);
+	int16 index = _NodeAt(position);
+
+	while (fNodes[index].redo != kNoNode) {
+		index = fNodes[index].redo;
+		position++;
+
+		fPath[position % kCapacity] = index;
+		board ^= fPressMasks[fNodes[index].button];
+		if (position % kCheckpointInterval == 0)
+			fCheckpoints[_CheckpointIndex(position)] = board;
+	}
+
+	fLength = position;
+}
+
+int16 MoveHistory::_AllocateNode()
+{
+	if (fFreeNodes == kNoNode)
+		_Collect();
+
+	const int16 index = fFreeNodes;
+	node& allocated = fNodes[index];
+	fFreeNodes = allocated.nextSibling;
+
+	allocated.firstChild = allocated.nextSibling = allocated.redo = kNoNode;
+	return index;
+}
+
+void MoveHistory::_FreeNode(int16 index)
+{
+	fNodes[index].nextSibling = fFreeNodes;
+	fFreeNodes = index;
+}
+
+/*
+ * Make room in a full pool: drop all branches off the line, or if there
+ * are none, what can be redone, or if there is nothing to redo either, the
+ * oldest quarter of the line.
+ */
+
+void MoveHistory::_Collect()
+{
+	bool isOnLine[kCapacity];
+	memset(isOnLine, 0, sizeof(isOnLine));
+
+	for (int32 position = fFirst; position <= fLength; position++)
+		isOnLine[_NodeAt(position)] = true;
+
+	for (int32 index = kCapacity - 1; index >= 0; index--) {
+		if (!isOnLine[index])
+			_FreeNode(index);
+	}
+
+	if (fFreeNodes != kNoNode) {
+		// what is left is a single chain
+		for (int32 position = fFirst; position <= fLength; position++) {
+			node& kept = fNodes[_NodeAt(position)];
+			kept.nextSibling = kNoNode;
+			kept.firstChild = kept.redo;
+		}
+		return;
+	}
+
+	if (fPosition < fLength) {
+		for (int32 position = fPosition + 1; position <= fLength; position++)
+			_FreeNode(_NodeAt(position));
+
+		node& current = fNodes[_NodeAt(fPosition)];
+		current.firstChild = current.redo = kNoNode;
+		fLength = fPosition;
+		return;
+	}
+
+	// a multiple of kCheckpointInterval, so the new start has a checkpoint
+	const int32 first = fFirst + kCapacity / 4;
+	assert(first <= fPosition);
+
+	for (int32 position = fFirst; position < first; position++)
+		_FreeNode(_NodeAt(position));
+
+	fFirst = first;
+}
@@ -0,0 +1,92 @@
+#ifndef MOVE_HISTORY_H
+#define MOVE_HISTORY_H
+
+#include "CoreDefs.h"
+
+class Grid;
+
+// The MoveHistory class remembers the moves played on a puzzle as a tree:
+// undoing a few moves and playing something else keeps the moves that were
+// undone as a branch, which can be switched back to later.
+//
+// The tree nodes come from a fixed pool inside the object, so recording a
+// move never allocates. The line being played, from the start through the
+// current position to the end of what can be redone, is kept in a ring of
+// node indices by move number, along with the board after every
+// kCheckpointInterval-th move. The board at any position on the line is
+// then its checkpoint XORed with the press masks of at most
+// kCheckpointInterval - 1 moves, whatever the length of the game.
+//
+// When the pool runs out, the branches off the current line are forgotten
+// first, then the moves that can be redone, and last the oldest quarter of
+// the line itself, so positions before First() can no longer be reached.
+
+class MoveHistory
+{
+public:
+	enum {
+		kCapacity = 4096,
+		kCheckpointInterval = 16
+	};
+
+	MoveHistory();
+
+	void Start(const Grid& grid);
+
+	void Press(int8 button);
+	bool PressOrUndo(int8 button);
+	bool Undo();
+	bool Redo();
+	void Seek(int32 position);
+
+	bool NextBranch();
+	bool PreviousBranch();
+	int32 CountBranches() const;
+
+	int32 Position() const { return fPosition; }
+	int32 Length() const { return fLength; }
+	int32 First() const { return fFirst; }
+
+	int8 MoveAt(int32 position) const;
+	uint64 Board() const { return fBoard; }
+	uint64 BoardAt(int32 position) const;
+
+private:
+	enum {
+		kNumCheckpoints = kCapacity / kCheckpointInterval,
+		kNoNode = -1
+	};
+
+	struct node {
+		int16	firstChild;
+		int16	nextSibling;	// or the next free node
+		int16	redo;			// the child Redo() goes to
+		int8	button;
+	};
+
+	int16 _NodeAt(int32 position) const
+		{ return fPath[position % kCapacity]; }
+	uint64 _MaskAt(int32 position) const
+		{ return fPressMasks[fNodes[_NodeAt(position)].button]; }
+	static int32 _CheckpointIndex(int32 position)
+		{ return position / kCheckpointInterval % kNumCheckpoints; }
+
+	void _SelectChild(int16 child);
+	void _ExtendLine(int32 position);
+	int16 _AllocateNode();
+	void _FreeNode(int16 index);
+	void _Collect();
+
+	uint64 fPressMasks[64];
+	uint64 fBoard;
+	int32 fFirst;
+	int32 fPosition;
+	int32 fLength;
+	int16 fFreeNodes;
+
+	node fNodes[kCapacity];
+	int16 fPath[kCapacity];
+	uint64 fCheckpoints[kNumCheckpoints];
+};
+
+#endif
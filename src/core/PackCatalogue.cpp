@@ -0,0 +1,206 @@
+#include "PackCatalogue.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+static const char magic[8] = { 'L', 'O', 'P', 'A', 'K', 'I', 'D', 'X' };
+
+
+PackCatalogue::PackCatalogue()
+	:
+	fNumHeadersRead(0),
+	fIsModified(false)
+{
+}
+
+/*
+ * Take the index saved by SaveIndex() at path, instead of whatever the
+ * catalogue knew before.
+ */
+
+status_t PackCatalogue::LoadIndex(const char* path)
+{
+	fIndex.clear();
+	fIsModified = false;
+
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return B_FROM_POSIX_ERROR(errno);
+
+	char fileMagic[sizeof(magic)];
+	uint32 version, numEntries;
+	bool isValid = fread(fileMagic, 1, sizeof(fileMagic), file)
+			== sizeof(fileMagic)
+		&& memcmp(fileMagic, magic, sizeof(magic)) == 0
+		&& fread(&version, sizeof(version), 1, file) == 1
+		&& version == kIndexVersion
+		&& fread(&numEntries, sizeof(numEntries), 1, file) == 1;
+
+	for (uint32 index = 0; isValid && index < numEntries; index++) {
+		entry entry;
+		entry.isCurrent = false;
+
+		char entryPath[PATH_MAX];
+		isValid = fread(&entry.index, sizeof(entry.index), 1, file) == 1
+			&& entry.index.pathLength < sizeof(entryPath)
+			&& fread(entryPath, 1, entry.index.pathLength, file)
+				== entry.index.pathLength;
+
+		if (isValid)
+			fIndex[std::string(entryPath, entry.index.pathLength)] = entry;
+	}
+
+	fclose(file);
+
+	if (!isValid) {
+		fIndex.clear();
+		return B_BAD_DATA;
+	}
+
+	return B_OK;
+}
+
+/*
+ * Write the entries of the files Scan() has come across since the index
+ * was loaded to path.
+ */
+
+status_t PackCatalogue::SaveIndex(const char* path) const
+{
+	FILE* file = fopen(path, "wb");
+	if (file == NULL)
+		return B_FROM_POSIX_ERROR(errno);
+
+	const uint32 version = kIndexVersion;
+	uint32 numEntries = 0;
+	for (index_map::const_iterator iterator = fIndex.begin();
+			iterator != fIndex.end(); iterator++) {
+		if (iterator->second.isCurrent)
+			numEntries++;
+	}
+
+	bool written = fwrite(magic, 1, sizeof(magic), file) == sizeof(magic)
+		&& fwrite(&version, sizeof(version), 1, file) == 1
+		&& fwrite(&numEntries, sizeof(numEntries), 1, file) == 1;
+
+	for (index_map::const_iterator iterator = fIndex.begin();
+			written && iterator != fIndex.end(); iterator++) {
+		if (!iterator->second.isCurrent)
+			continue;
+
+		const std::string& entryPath = iterator->first;
+		written = fwrite(&iterator->second.index,
+				sizeof(iterator->second.index), 1, file) == 1
+			&& fwrite(entryPath.c_str(), 1, entryPath.size(), file)
+				== entryPath.size();
+	}
+
+	status_t status = written ? B_OK : B_FROM_POSIX_ERROR(errno);
+
+	if (fclose(file) != 0 && status == B_OK)
+		status = B_FROM_POSIX_ERROR(errno);
+
+	if (status != B_OK)
+		unlink(path);
+
+	return status;
+}
+
+/*
+ * Whether saving the index would change it: a file had to be read, or one
+ * in the index wasn't seen again.
+ */
+
+bool PackCatalogue::IsModified() const
+{
+	if (fIsModified)
+		return true;
+
+	for (index_map::const_iterator iterator = fIndex.begin();
+			iterator != fIndex.end(); iterator++) {
+		if (!iterator->second.isCurrent)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Add a pack for every pack file in directory to packs, in the order of
+ * their file names. None of them is loaded yet.
+ */
+
+status_t PackCatalogue::Scan(const char* directory, PuzzlePackSet& packs)
+{
+	DIR* dir = opendir(directory);
+	if (dir == NULL)
+		return B_FROM_POSIX_ERROR(errno);
+
+	std::vector<std::string> names;
+
+	while (struct dirent* dirent = readdir(dir)) {
+		if (dirent->d_name[0] != '.')
+			names.push_back(dirent->d_name);
+	}
+
+	closedir(dir);
+	std::sort(names.begin(), names.end());
+
+	for (size_t index = 0; index < names.size(); index++) {
+		const std::string path = std::string(directory) + "/" + names[index];
+
+		struct stat info;
+		if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode))
+			continue;
+
+		const int64 modified = (int64) info.st_mtim.tv_sec * 1000000000
+			+ info.st_mtim.tv_nsec;
+
+		entry& entry = fIndex[path];
+		if (entry.index.modified != modified
+			|| entry.index.size != (uint64) info.st_size) {
+			memset(&entry.index, 0, sizeof(entry.index));
+			entry.index.modified = modified;
+			entry.index.size = info.st_size;
+			entry.index.pathLength = path.size();
+
+			_ReadHeader(path.c_str(), entry.index);
+			fNumHeadersRead++;
+			fIsModified = true;
+		}
+
+		entry.isCurrent = true;
+
+		if (entry.index.isValid)
+			packs.AddPack(new PuzzlePack(path.c_str(), entry.index.header));
+	}
+
+	return B_OK;
+}
+
+/*
+ * Fill in the header of the pack file at path, and whether it is one.
+ */
+
+void PackCatalogue::_ReadHeader(const char* path, pack_index_entry& index)
+{
+	index.isValid = false;
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return;
+
+	if (pread(fd, &index.header, sizeof(index.header), 0)
+			== sizeof(index.header))
+		index.isValid = PuzzlePack::CheckHeader(index.header, index.size);
+
+	close(fd);
+}
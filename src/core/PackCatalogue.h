@@ -0,0 +1,68 @@
+#ifndef PACK_CATALOGUE_H
+#define PACK_CATALOGUE_H
+
+#include <map>
+#include <string>
+
+#include "CoreDefs.h"
+#include "PuzzlePack.h"
+
+// The PackCatalogue class finds the pack files in a directory and adds them
+// to a PuzzlePackSet without mapping any of them: each pack only gets what
+// the header of its file says, and PuzzlePack::Load() maps the boards once
+// the pack is actually played.
+//
+// Even reading the headers means opening every file, so the catalogue
+// keeps an index of the headers it has read, keyed by path, which can be
+// saved and loaded again on the next start. A file whose modification time
+// and size are still those in the index is taken from it, and only new and
+// changed files are opened. Files that aren't valid pack files are indexed
+// as well, so they aren't read again either.
+//
+// The index file starts with a magic, a version and the number of
+// entries, followed by one pack_index_entry and its path per file, all in
+// the byte order of the machine that wrote it.
+
+struct pack_index_entry {
+	int64	modified;		// in nanoseconds
+	uint64	size;
+	uint16	pathLength;
+	uint8	isValid;
+	uint8	reserved[5];
+	puzzle_pack_header header;
+};
+
+
+class PackCatalogue
+{
+public:
+	enum {
+		kIndexVersion = 1
+	};
+
+	PackCatalogue();
+
+	status_t LoadIndex(const char* path);
+	status_t SaveIndex(const char* path) const;
+	bool IsModified() const;
+
+	status_t Scan(const char* directory, PuzzlePackSet& packs);
+
+	int32 CountHeadersRead() const { return fNumHeadersRead; }
+
+private:
+	struct entry {
+		pack_index_entry	index;
+		bool				isCurrent;	// seen by Scan() since loading
+	};
+
+	typedef std::map<std::string, entry> index_map;
+
+	static void _ReadHeader(const char* path, pack_index_entry& index);
+
+	index_map fIndex;
+	int32 fNumHeadersRead;
+	bool fIsModified;
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include "PuzzleGenerator.h"
+
+#include <assert.h>
+
+#include <mutex>
+#include <string>
+
+#include "DistanceDatabase.h"
+#include "Grid.h"
+#include "PuzzleTables.h"
+#include "Solver.h"
+#include "StateSpace.h"
+
+// built on first use and kept for the lifetime of the process
+static PuzzleGenerator* sGenerators[9];
+static std::once_flag sGeneratorsBuilt[9];
+static std::string sDatabaseDirectory;
+
+// the hardest 4x4 puzzles, as counted by StateSpaceEnumerator
+static_assert(PuzzleTableList<4>::kMaxMoves == 7, "4x4 table is wrong");
+static_assert(PuzzleTable<4, 5>::kCount == 1440
+	&& PuzzleTable<4, 6>::kCount == 540 && PuzzleTable<4, 7>::kCount == 32,
+	"4x4 table is wrong");
+static_assert(PuzzleTable<3, 4>::kCount == 126, "3x3 table is wrong");
+
+
+static puzzle_table_entry
+PuzzleTableAt(int8 dimension, int32 moves)
+{
+	switch (dimension) {
+		case 1:
+			return PuzzleTableList<1>::At(moves);
+		case 2:
+			return PuzzleTableList<2>::At(moves);
+		case 3:
+			return PuzzleTableList<3>::At(moves);
+		case 4:
+			return PuzzleTableList<4>::At(moves);
+	}
+
+	return puzzle_table_entry{ NULL, 0 };
+}
+
+
+/*
+ * The PuzzleGenerator for dimension. Each dimension is built once, by the
+ * first thread to ask for it; others asking for the same one wait for it,
+ * but not for the 5x5 state space while they ask for another dimension.
+ */
+
+const PuzzleGenerator& PuzzleGenerator::ForDimension(int8 dimension)
+{
+	assert(dimension > 0 && dimension <= 8);
+
+	std::call_once(sGeneratorsBuilt[dimension], [dimension]() {
+		sGenerators[dimension] = new PuzzleGenerator(dimension);
+	});
+
+	return *sGenerators[dimension];
+}
+
+/*
+ * Look for distance databases in directory, and write those that had to be
+ * enumerated there. Only generators built after this call do either, so it
+ * is meant to be called before the first ForDimension().
+ */
+
+void PuzzleGenerator::SetDatabaseDirectory(const char* directory)
+{
+	sDatabaseDirectory = directory != NULL ? directory : "";
+}
+
+PuzzleGenerator::PuzzleGenerator(int8 dimension)
+	:
+	fDimension(dimension),
+	fMaxMoves(dimension * dimension),
+	fDistances(NULL),
+	fDatabase(NULL),
+	fStateSpace(NULL)
+{
+	assert(dimension > 0 && dimension <= 8);
+
+	while (dimension <= 4 && PuzzleTableAt(dimension, fMaxMoves).count == 0)
+		fMaxMoves--;
+
+	if (dimension > 4 && dimension <= StateSpace::kMaxDimension) {
+		const std::string path = sDatabaseDirectory.empty() ? std::string()
+			: DistanceDatabase::Path(sDatabaseDirectory.c_str(), dimension);
+
+		fDatabase = new DistanceDatabase;
+		if (path.empty() || fDatabase->Open(path.c_str()) != B_OK
+			|| fDatabase->Dimension() != dimension) {
+			delete fDatabase;
+			fDatabase = NULL;
+
+			// failing to write it only costs the next start the same time
+			fStateSpace = new StateSpace(dimension);
+			if (!path.empty())
+				DistanceDatabase::Write(path.c_str(), *fStateSpace);
+		}
+
+		fDistances = fDatabase != NULL
+			? &fDatabase->Distances() : &fStateSpace->Distances();
+		fMaxMoves = fDistances->MaxMoves();
+	}
+
+	// any press set of the larger grids is its puzzle's only solution
+	assert(dimension <= StateSpace::kMaxDimension
+		|| Solver::ForDimension(dimension).Nullity() == 0);
+}
+
+PuzzleGenerator::~PuzzleGenerator()
+{
+	delete fDatabase;
+	delete fStateSpace;
+}
+
+/*
+ * A random puzzle whose optimal solution takes exactly moves presses, or the
+ * hardest puzzles there are if moves is above MaxMoves().
+ */
+
+uint64 PuzzleGenerator::RandomPuzzle(int8 moves,
+	RandomGenerator& generator) const
+{
+	if (moves > fMaxMoves)
+		moves = fMaxMoves;
+
+	if (fDimension <= 4) {
+		const puzzle_table_entry table = PuzzleTableAt(fDimension, moves);
+		if (table.count == 0)
+			return 0;
+
+		return table.puzzles[generator.Uniform(table.count)];
+	}
+
+	if (fDistances != NULL)
+		return fDistances->RandomBoard(moves, generator);
+
+	// the first moves buttons of a random order (a partial Fisher-Yates
+	// shuffle), every set of that many equally likely
+	const int32 numButtons = fDimension * fDimension;
+	int8 buttons[64];
+	uint64 lights = 0;
+
+	for (int32 index = 0; index < numButtons; index++)
+		buttons[index] = index;
+
+	for (int32 index = 0; index < moves; index++) {
+		const int32 other = index + generator.Uniform(numButtons - index);
+		const int8 button = buttons[other];
+		buttons[other] = buttons[index];
+		buttons[index] = button;
+
+		lights ^= Grid::PressMask(fDimension, button);
+	}
+
+	return lights;
+}
@@ -0,0 +1,47 @@
+#ifndef PUZZLE_GENERATOR_H
+#define PUZZLE_GENERATOR_H
+
+#include "CoreDefs.h"
+#include "Random.h"
+
+// The PuzzleGenerator class creates puzzles on grids up to 8x8 whose optimal
+// solution takes exactly the requested number of moves, picked evenly from
+// all puzzles of that difficulty. Up to 4x4 they come from the compile-time
+// PuzzleTable of the move count. 5x5 draws each puzzle in a few
+// microseconds from the distances of all its boards: those of the
+// DistanceDatabase in the directory given to SetDatabaseDirectory(), which
+// is mapped rather than read, or else of a StateSpace that takes about a
+// second on one core to enumerate and keeps 16.5 MB. An enumerated state
+// space is written to that directory, so that the next start can map it.
+// 6x6 through 8x8 have a nullity of 0, so every press set is the only
+// solution of its puzzle and pressing that many random buttons is enough.
+
+class BoardDistances;
+class DistanceDatabase;
+class StateSpace;
+
+
+class PuzzleGenerator
+{
+public:
+	PuzzleGenerator(int8 dimension);
+	~PuzzleGenerator();
+
+	static const PuzzleGenerator& ForDimension(int8 dimension);
+	static void SetDatabaseDirectory(const char* directory);
+
+	int8 Dimension() const { return fDimension; }
+	int32 MaxMoves() const { return fMaxMoves; }
+
+	uint64 RandomPuzzle(int8 moves, RandomGenerator& generator
+		= RandomGenerator::ForThread()) const;
+
+private:
+	int8 fDimension;
+	int32 fMaxMoves;
+	const BoardDistances* fDistances;
+	DistanceDatabase* fDatabase;
+	StateSpace* fStateSpace;
+};
+
+#endif
@@ -1,10 +1,18 @@
 #include "PuzzlePack.h"
 
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Solver.h"
+
+static const char magic[8] = { 'L', 'O', 'P', 'U', 'Z', 'P', 'A', 'K' };
+
 class ClassicPuzzlePack : public PuzzlePack
 {
 public:
 	ClassicPuzzlePack(const char *name, uint32 *data, const uint32 size);
-	uint8 MovesRequired(const uint32 &index);
+	uint8 MovesRequired(const uint32 &index, int32 optimum = -1);
 };
 
 static uint32 DefaultPack[] = 
@@ -253,58 +261,535 @@ static uint32 FifteenPack[] = {
 
 PuzzlePackSet::PuzzlePackSet(void)
 {
-	fList.AddItem(new ClassicPuzzlePack("Classic",DefaultPack,50));
-	fList.AddItem(new PuzzlePack("Six move puzzles",SixPack,100,6));
-	fList.AddItem(new PuzzlePack("Seven move puzzles",SevenPack,100,7));
-	fList.AddItem(new PuzzlePack("Eight move puzzles",EightPack,100,8));
-	fList.AddItem(new PuzzlePack("Nine move puzzles",NinePack,100,9));
-	fList.AddItem(new PuzzlePack("Ten move puzzles",TenPack,100,10));
-	fList.AddItem(new PuzzlePack("Eleven move puzzles",ElevenPack,100,11));
-	fList.AddItem(new PuzzlePack("Twelve move puzzles",TwelvePack,100,12));
-	fList.AddItem(new PuzzlePack("Thirteen move puzzles",ThirteenPack,100,13));
-	fList.AddItem(new PuzzlePack("Fourteen move puzzles",FourteenPack,100,14));
-	fList.AddItem(new PuzzlePack("Fifteen move puzzles",FifteenPack,100,15));
+	fList.push_back(new ClassicPuzzlePack("Classic",DefaultPack,50));
+	fList.push_back(new PuzzlePack("Six move puzzles",SixPack,100,6));
+	fList.push_back(new PuzzlePack("Seven move puzzles",SevenPack,100,7));
+	fList.push_back(new PuzzlePack("Eight move puzzles",EightPack,100,8));
+	fList.push_back(new PuzzlePack("Nine move puzzles",NinePack,100,9));
+	fList.push_back(new PuzzlePack("Ten move puzzles",TenPack,100,10));
+	fList.push_back(new PuzzlePack("Eleven move puzzles",ElevenPack,100,11));
+	fList.push_back(new PuzzlePack("Twelve move puzzles",TwelvePack,100,12));
+	fList.push_back(new PuzzlePack("Thirteen move puzzles",ThirteenPack,100,13));
+	fList.push_back(new PuzzlePack("Fourteen move puzzles",FourteenPack,100,14));
+	fList.push_back(new PuzzlePack("Fifteen move puzzles",FifteenPack,100,15));
 }
 
 PuzzlePackSet::~PuzzlePackSet(void)
 {
-	for(int32 i=0; i<fList.CountItems(); i++)
-	{
-		PuzzlePack *pack = (PuzzlePack*)fList.ItemAt(i);
+	for(size_t i=0; i<fList.size(); i++)
+		delete fList[i];
+}
+
+/*
+ * Open the pack file at path and add it after the packs already in the set.
+ */
+
+status_t PuzzlePackSet::AddPack(const char* path)
+{
+	PuzzlePack* pack = new PuzzlePack;
+
+	status_t status = pack->Open(path);
+	if (status != B_OK) {
 		delete pack;
+		return status;
 	}
+
+	fList.push_back(pack);
+	return B_OK;
+}
+
+/*
+ * Add pack to the set, which then owns it.
+ */
+
+void PuzzlePackSet::AddPack(PuzzlePack* pack)
+{
+	fList.push_back(pack);
 }
 
 
 PuzzlePack::PuzzlePack(const char *name, uint32 *data, const uint32 size,
 						const uint8 &moves)
+	:
+	fBoards(NULL),
+	fMoveCounts(NULL),
+	fHighest(0)
+{
+	const int8 dimension = 5;
+
+	puzzle_pack_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = kVersion;
+	header.dimension = dimension;
+	header.shape = kPlusNeighbourhood;
+	header.numPuzzles = size;
+	header.bitsPerBoard = dimension * dimension;
+	header.movesRequired = moves;
+	header.dataSize = _BoardsSize(size, header.bitsPerBoard);
+	strncpy(header.name, name, sizeof(header.name) - 1);
+
+	// a board shifted into place still fits in the eight bytes at its start
+	fData.assign(header.dataSize, 0);
+	for (uint32 index = 0; index < size; index++) {
+		const uint64 bit = (uint64) index * header.bitsPerBoard;
+		uint8* bytes = &fData[bit / 8];
+		const uint64 value = (uint64) data[index] << (bit % 8);
+
+		for (int32 byte = 0; byte < 8; byte++)
+			bytes[byte] |= (uint8) (value >> (byte * 8));
+	}
+
+	header.checksum = MappedFile::Checksum(&fData[0], fData.size());
+	_SetHeader(header, &fData[0]);
+}
+
+PuzzlePack::PuzzlePack()
+	:
+	fBoards(NULL),
+	fMoveCounts(NULL),
+	fHighest(0)
+{
+	Close();
+}
+
+/*
+ * A pack that knows what the header of the pack file at path says, but
+ * doesn't map the file until Load() is called.
+ */
+
+PuzzlePack::PuzzlePack(const char* path, const puzzle_pack_header& header)
+	:
+	fPath(path),
+	fBoards(NULL),
+	fMoveCounts(NULL),
+	fHighest(0)
+{
+	_SetHeader(header, NULL);
+}
+
+PuzzlePack::~PuzzlePack(void)
+{
+	Close();
+}
+
+/*
+ * Map the pack file at path and check that its header describes a pack
+ * this version can read and that the file is large enough to hold it.
+ */
+
+status_t PuzzlePack::Open(const char* path)
+{
+	Close();
+	fPath = path;
+
+	puzzle_pack_header header;
+	status_t status = fFile.ReadHeader(path, &header, sizeof(header),
+		kDataOffset);
+	if (status != B_OK)
+		return status;
+
+	if (!CheckHeader(header, fFile.FileSize())) {
+		fFile.Close();
+		return B_BAD_DATA;
+	}
+
+	status = fFile.Map(kDataOffset + header.dataSize);
+	if (status != B_OK)
+		return status;
+
+	_SetHeader(header, fFile.Data() + kDataOffset);
+
+	return B_OK;
+}
+
+/*
+ * Map the pack file the pack was created for, if that hasn't happened yet.
+ * Built-in packs are always loaded.
+ */
+
+status_t PuzzlePack::Load()
+{
+	if (IsLoaded())
+		return B_OK;
+
+	if (fPath.empty())
+		return B_NO_INIT;
+
+	// keep what the catalogue said about the pack if the file is gone
+	const std::string path = fPath;
+	const puzzle_pack_header header = fHeader;
+
+	status_t status = Open(path.c_str());
+	if (status != B_OK)
+		_SetHeader(header, NULL);
+
+	return status;
+}
+
+void PuzzlePack::Close()
 {
-	fName=name;
-	fSize=size;
-	fData=data;
-	fMoves=moves;
-	fHighest=0;
+	fFile.Close();
+	fData.clear();
+
+	puzzle_pack_header header;
+	memset(&header, 0, sizeof(header));
+	_SetHeader(header, NULL);
+}
+
+/*
+ * Whether header describes a pack this version can read, and a file of
+ * fileSize bytes is large enough to hold it.
+ */
+
+bool PuzzlePack::CheckHeader(const puzzle_pack_header& header,
+	uint64 fileSize)
+{
+	if (memcmp(header.magic, magic, sizeof(magic)) != 0
+		|| header.version != kVersion || header.dimension < 1
+		|| header.dimension > 8 || header.shape >= kNumNeighbourhoods
+		|| header.toroidal > 1 || (header.toroidal && header.dimension < 3)
+		|| header.bitsPerBoard != header.dimension * header.dimension
+		|| memchr(header.name, '\0', sizeof(header.name)) == NULL)
+		return false;
+
+	uint64 dataSize = _BoardsSize(header.numPuzzles, header.bitsPerBoard);
+	if ((header.flags & kHasMoveCounts) != 0)
+		dataSize += header.numPuzzles;
+
+	return header.dataSize == dataSize
+		&& fileSize >= kDataOffset + header.dataSize;
 }
 
-uint32 PuzzlePack::ValueAt(const uint32 &index)
+status_t PuzzlePack::InitCheck() const
 {
-	if(index>fSize-1)
-		return 0;
-	
-	return fData[index];
+	return fBoards != NULL ? B_OK : B_NO_INIT;
 }
 
-uint8 PuzzlePack::MovesRequired(const uint32 &index)
+/*
+ * Compare the boards and move counts against the checksum in the header.
+ * This reads every page of a pack file, so it's meant for tools rather than
+ * the application.
+ */
+
+status_t PuzzlePack::Verify() const
 {
-	return fMoves;
+	if (fBoards == NULL)
+		return B_NO_INIT;
+
+	if (MappedFile::Checksum(fBoards, fHeader.dataSize) != fHeader.checksum)
+		return B_BAD_DATA;
+
+	return B_OK;
+}
+
+Rules PuzzlePack::GetRules(void) const
+{
+	return Rules((neighbourhood) fHeader.shape, fHeader.toroidal != 0);
+}
+
+/*
+ * The moves a puzzle may be solved in, not counting the extra moves a
+ * player is allowed. Packs that don't store it allow the fewest moves the
+ * puzzle can be solved in; callers that already know that number, like a
+ * HintEngine on the puzzle, pass it as optimum so it isn't solved again.
+ */
+
+uint8 PuzzlePack::MovesRequired(const uint32 &index, int32 optimum)
+{
+	if ((fHeader.flags & kHasMoveCounts) != 0)
+		return index < fNumBoards ? fMoveCounts[index] : 0;
+
+	if (fHeader.movesRequired != 0 || index >= fNumBoards)
+		return fHeader.movesRequired;
+
+	if (optimum < 0) {
+		optimum = Solver::ForDimension(Dimension(), GetRules())
+			.MinimumMoves(ValueAt(index));
+	}
+
+	return optimum > 0 ? optimum : 0;
+}
+
+/*
+ * Write pack to path as a pack file. The move counts are only stored if
+ * they differ between puzzles.
+ */
+
+status_t PuzzlePack::Write(const char* path, PuzzlePack& pack)
+{
+	if (pack.InitCheck() != B_OK)
+		return B_NO_INIT;
+
+	PackWriter writer;
+	status_t status = writer.Open(path, pack.Name(), pack.Dimension(),
+		pack.GetRules());
+
+	for (uint32 index = 0; status == B_OK && index < pack.Size(); index++)
+		status = writer.Add(pack.ValueAt(index), pack.MovesRequired(index));
+
+	if (status != B_OK)
+		return status;
+
+	return writer.Close();
 }
 
+void PuzzlePack::_SetHeader(const puzzle_pack_header& header,
+	const uint8* data)
+{
+	fHeader = header;
+	fName = header.name;
+	fBoards = data;
+	fMoveCounts = NULL;
+	fNumBoards = data != NULL ? header.numPuzzles : 0;
+
+	if (data != NULL && (header.flags & kHasMoveCounts) != 0)
+		fMoveCounts = data + _BoardsSize(header.numPuzzles,
+			header.bitsPerBoard);
+
+	fBoardMask = header.bitsPerBoard < 64
+		? ((uint64) 1 << header.bitsPerBoard) - 1 : ~(uint64) 0;
+}
+
+PackWriter::PackWriter()
+	:
+	fFile(NULL),
+	fStatus(B_NO_INIT),
+	fMoveCounts(NULL)
+{
+}
+
+PackWriter::~PackWriter()
+{
+	_Abort();
+}
+
+/*
+ * Start a pack file at path for puzzles of the given dimension and rules.
+ * The file is only complete once Close() succeeds; until then it holds no
+ * valid header, and it is removed if writing fails.
+ */
+
+status_t PackWriter::Open(const char* path, const char* name,
+	int8 dimension, const Rules& rules)
+{
+	_Abort();
+
+	if (dimension < 1 || dimension > 8
+		|| (rules.IsToroidal() && dimension < 3))
+		return B_BAD_VALUE;
+
+	memset(&fHeader, 0, sizeof(fHeader));
+	memcpy(fHeader.magic, magic, sizeof(magic));
+	fHeader.version = PuzzlePack::kVersion;
+	fHeader.dimension = dimension;
+	fHeader.shape = rules.Shape();
+	fHeader.toroidal = rules.IsToroidal();
+	fHeader.bitsPerBoard = dimension * dimension;
+	strncpy(fHeader.name, name, sizeof(fHeader.name) - 1);
+
+	fFile = fopen(path, "wb");
+	if (fFile == NULL)
+		return fStatus = B_FROM_POSIX_ERROR(errno);
+
+	fPath = path;
+	fChecksum = MappedFile::kChecksumStart;
+	fBoardMask = fHeader.bitsPerBoard < 64
+		? ((uint64) 1 << fHeader.bitsPerBoard) - 1 : ~(uint64) 0;
+	fPendingBits = 0;
+	fNumPendingBits = 0;
+	fFirstMoves = 0;
+	fBufferUsed = 0;
+
+	// the header is written last, when its sizes and checksum are known
+	const uint8 padding[PuzzlePack::kDataOffset] = { 0 };
+	fStatus = fwrite(padding, 1, sizeof(padding), fFile) == sizeof(padding)
+		? B_OK : B_FROM_POSIX_ERROR(errno);
+
+	return fStatus;
+}
+
+/*
+ * Append a puzzle that takes moves moves to the pack.
+ */
+
+status_t PackWriter::Add(uint64 board, uint8 moves)
+{
+	if (fStatus != B_OK)
+		return fStatus;
+
+	if ((board & ~fBoardMask) != 0 || fHeader.numPuzzles == UINT32_MAX)
+		return B_BAD_VALUE;
+
+	if (fHeader.numPuzzles == 0)
+		fFirstMoves = moves;
+
+	if (moves != fFirstMoves && fMoveCounts == NULL) {
+		// every puzzle so far took the same number of moves
+		fMoveCounts = tmpfile();
+		if (fMoveCounts == NULL)
+			return fStatus = B_FROM_POSIX_ERROR(errno);
+
+		for (uint32 index = 0; index < fHeader.numPuzzles; index++)
+			putc(fFirstMoves, fMoveCounts);
+	}
+
+	if (fMoveCounts != NULL && putc(moves, fMoveCounts) == EOF)
+		return fStatus = B_FROM_POSIX_ERROR(errno);
+
+	const int32 bits = fHeader.bitsPerBoard;
+	const uint64 word = fPendingBits | board << fNumPendingBits;
+
+	if (fNumPendingBits + bits < 64) {
+		fPendingBits = word;
+		fNumPendingBits += bits;
+	} else {
+		_AddWord(word);
+		fPendingBits = fNumPendingBits > 0
+			? board >> (64 - fNumPendingBits) : 0;
+		fNumPendingBits += bits - 64;
+	}
+
+	fHeader.numPuzzles++;
+	return fStatus;
+}
+
+/*
+ * Finish the boards, append the move counts if they differ, and write the
+ * header. The file is removed if any of that fails.
+ */
+
+status_t PackWriter::Close()
+{
+	if (fStatus != B_OK) {
+		status_t status = fStatus;
+		_Abort();
+		return status;
+	}
+
+	// the last board is followed by a whole word of padding
+	if (fNumPendingBits > 0)
+		_AddWord(fPendingBits);
+	_AddWord(0);
+
+	fHeader.dataSize = PuzzlePack::_BoardsSize(fHeader.numPuzzles,
+		fHeader.bitsPerBoard);
+
+	if (fMoveCounts != NULL) {
+		fHeader.flags |= PuzzlePack::kHasMoveCounts;
+		fHeader.dataSize += fHeader.numPuzzles;
+		if (fStatus == B_OK)
+			fStatus = _CopyMoveCounts();
+	} else
+		fHeader.movesRequired = fFirstMoves;
+
+	if (fStatus == B_OK)
+		fStatus = _Flush();
+
+	fHeader.checksum = fChecksum;
+
+	if (fStatus == B_OK && (fseek(fFile, 0, SEEK_SET) != 0
+			|| fwrite(&fHeader, sizeof(fHeader), 1, fFile) != 1))
+		fStatus = B_FROM_POSIX_ERROR(errno);
+
+	if (fclose(fFile) != 0 && fStatus == B_OK)
+		fStatus = B_FROM_POSIX_ERROR(errno);
+	fFile = NULL;
+
+	status_t status = fStatus;
+	if (status != B_OK)
+		unlink(fPath.c_str());
+
+	_Abort();
+	return status;
+}
+
+void PackWriter::_AddWord(uint64 word)
+{
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	word = __builtin_bswap64(word);
+#endif
+	memcpy(fBuffer + fBufferUsed, &word, sizeof(word));
+	fBufferUsed += sizeof(word);
+
+	if (fBufferUsed == sizeof(fBuffer) && fStatus == B_OK)
+		fStatus = _Flush();
+}
+
+/*
+ * Write out the buffer and add what it holds to the checksum.
+ */
+
+status_t PackWriter::_Flush()
+{
+	fChecksum = MappedFile::Checksum(fBuffer, fBufferUsed, fChecksum);
+
+	const bool written
+		= fwrite(fBuffer, 1, fBufferUsed, fFile) == fBufferUsed;
+	fBufferUsed = 0;
+
+	return written ? B_OK : B_FROM_POSIX_ERROR(errno);
+}
+
+/*
+ * Append the move counts from the temporary file to the boards.
+ */
+
+status_t PackWriter::_CopyMoveCounts()
+{
+	if (fflush(fMoveCounts) != 0 || fseek(fMoveCounts, 0, SEEK_SET) != 0)
+		return B_FROM_POSIX_ERROR(errno);
+
+	for (uint32 left = fHeader.numPuzzles; left > 0;) {
+		if (fBufferUsed == sizeof(fBuffer)) {
+			status_t status = _Flush();
+			if (status != B_OK)
+				return status;
+		}
+
+		size_t size = sizeof(fBuffer) - fBufferUsed;
+		if (size > left)
+			size = left;
+
+		if (fread(fBuffer + fBufferUsed, 1, size, fMoveCounts) != size) {
+			return ferror(fMoveCounts)
+				? B_FROM_POSIX_ERROR(errno) : B_BAD_DATA;
+		}
+
+		fBufferUsed += size;
+		left -= size;
+	}
+
+	return B_OK;
+}
+
+/*
+ * Drop whatever was written so far.
+ */
+
+void PackWriter::_Abort()
+{
+	if (fFile != NULL) {
+		fclose(fFile);
+		unlink(fPath.c_str());
+	}
+
+	if (fMoveCounts != NULL)
+		fclose(fMoveCounts);
+
+	fFile = NULL;
+	fMoveCounts = NULL;
+	fStatus = B_NO_INIT;
+	fBufferUsed = 0;
+}
+
+
 ClassicPuzzlePack::ClassicPuzzlePack(const char *name, uint32 *data, const uint32 size)
 	: PuzzlePack(name,data,size,0)
 {
 }
 
-uint8 ClassicPuzzlePack::MovesRequired(const uint32 &index)
+uint8 ClassicPuzzlePack::MovesRequired(const uint32 &index, int32 optimum)
 {
 	return 6 + (index/5);
 }
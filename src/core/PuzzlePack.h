@@ -0,0 +1,206 @@
+#ifndef PUZZLEPACK_H
+#define PUZZLEPACK_H
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "CoreDefs.h"
+#include "MappedFile.h"
+#include "Rules.h"
+
+// A PuzzlePack is either one of the packs built into the application or a
+// pack file, which is mapped read-only rather than read in, so opening even
+// a pack of thousands of puzzles only reads its header.
+//
+// A pack file starts with a puzzle_pack_header, in the byte order of the
+// machine that wrote it, followed at kDataOffset by the boards, packed
+// tightly at dimension * dimension bits each: board i starts at bit
+// i * bitsPerBoard, counted from the least significant bit of the first
+// byte, in the layout of Grid::GetGridValues(). The boards are padded to a
+// whole number of uint64 words plus one, so that ValueAt() can always load
+// a full word. If kHasMoveCounts is set in the flags, one byte per puzzle
+// with the moves it requires follows; otherwise every puzzle requires
+// movesRequired moves, or if that is 0 too, as many as it takes to solve.
+//
+// Built-in packs are kept in the same layout in memory, so ValueAt() reads
+// both the same way. Open() checks the header but not the checksum, which
+// would mean reading the whole file; Verify() does that on request.
+//
+// A pack can also be created from the header of a pack file alone, as
+// PackCatalogue does, so its name, dimension and size are known without
+// mapping anything. Such a pack is empty until Load() maps the file.
+//
+// Pack files are written by a PackWriter, one puzzle at a time through a
+// buffer of fixed size, so that a pack never has to be held in memory as a
+// whole. Write() goes through one as well.
+
+struct puzzle_pack_header {
+	char	magic[8];
+	uint32	version;
+	uint8	dimension;
+	uint8	shape;			// a neighbourhood
+	uint8	toroidal;
+	uint8	flags;
+	uint32	numPuzzles;
+	uint8	bitsPerBoard;
+	uint8	movesRequired;	// for every puzzle, or 0
+	uint16	reserved;
+	uint64	dataSize;		// boards and move counts
+	uint64	checksum;		// FNV-1a of the data
+	char	name[64];
+};
+
+
+class PuzzlePack
+{
+public:
+	enum {
+		kVersion = 1,
+		kDataOffset = 128,
+		kHasMoveCounts = 0x01
+	};
+
+	PuzzlePack(const char *name, uint32 *data, const uint32 size,const uint8 &moves);
+	PuzzlePack();
+	PuzzlePack(const char* path, const puzzle_pack_header& header);
+	virtual ~PuzzlePack(void);
+
+	status_t Open(const char* path);
+	status_t Load();
+	void Close();
+	status_t InitCheck() const;
+	bool IsLoaded() const { return fBoards != NULL; }
+	status_t Verify() const;
+
+	static bool CheckHeader(const puzzle_pack_header& header,
+		uint64 fileSize);
+
+	const char *Name(void) const { return fName.c_str(); }
+	uint32	Size(void) const { return fHeader.numPuzzles; }
+	int8	Dimension(void) const { return fHeader.dimension; }
+	Rules	GetRules(void) const;
+
+	uint64 ValueAt(uint32 index) const
+	{
+		if (index >= fNumBoards)
+			return 0;
+
+		const uint64 bit = (uint64) index * fHeader.bitsPerBoard;
+		const uint8* bytes = fBoards + bit / 8;
+		const int32 shift = bit % 8;
+
+		uint64 value = _LoadWord(bytes) >> shift;
+		if (shift + fHeader.bitsPerBoard > 64)
+			value |= (uint64) bytes[8] << (64 - shift);
+
+		return value & fBoardMask;
+	}
+
+	virtual uint8 MovesRequired(const uint32 &index, int32 optimum = -1);
+	void SetHighest(const uint32 &highest) { fHighest = highest; }
+	uint32 Highest(void) const { return fHighest; }
+
+	static status_t Write(const char* path, PuzzlePack& pack);
+
+private:
+	friend class PackWriter;
+
+	PuzzlePack(const PuzzlePack&);
+	PuzzlePack& operator=(const PuzzlePack&);
+
+	void _SetHeader(const puzzle_pack_header& header, const uint8* data);
+
+	// the eight bytes at bytes as a little endian word
+	static uint64 _LoadWord(const uint8* bytes)
+	{
+		uint64 word;
+		memcpy(&word, bytes, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		word = __builtin_bswap64(word);
+#endif
+		return word;
+	}
+
+	static size_t _BoardsSize(uint32 numPuzzles, uint8 bitsPerBoard)
+		{ return ((uint64) numPuzzles * bitsPerBoard + 63) / 64 * 8 + 8; }
+
+	std::string	fName;
+	std::string	fPath;
+	puzzle_pack_header fHeader;
+	const uint8* fBoards;
+	const uint8* fMoveCounts;
+	uint32	fNumBoards;		// 0 until the boards are there
+	uint64	fBoardMask;
+	uint32	fHighest;
+
+	// built-in packs
+	std::vector<uint8> fData;
+	// pack files
+	MappedFile fFile;
+};
+
+class PackWriter
+{
+public:
+	enum {
+		kBufferSize = 64 * 1024
+	};
+
+	PackWriter();
+	~PackWriter();
+
+	status_t Open(const char* path, const char* name, int8 dimension,
+		const Rules& rules);
+	status_t Add(uint64 board, uint8 moves);
+	status_t Close();
+
+	uint32 CountPuzzles() const { return fHeader.numPuzzles; }
+
+private:
+	PackWriter(const PackWriter&);
+	PackWriter& operator=(const PackWriter&);
+
+	void _AddWord(uint64 word);
+	status_t _Flush();
+	status_t _CopyMoveCounts();
+	void _Abort();
+
+	std::string	fPath;
+	FILE*	fFile;
+	puzzle_pack_header fHeader;
+	status_t fStatus;
+	uint64	fChecksum;
+	uint64	fBoardMask;
+
+	// bits of the boards not yet making up a whole word
+	uint64	fPendingBits;
+	int32	fNumPendingBits;
+
+	// the move counts, in a temporary file once they start to differ
+	FILE*	fMoveCounts;
+	uint8	fFirstMoves;
+
+	uint8	fBuffer[kBufferSize];
+	size_t	fBufferUsed;
+};
+
+class PuzzlePackSet
+{
+public:
+	PuzzlePackSet(void);
+	~PuzzlePackSet(void);
+
+	PuzzlePack *PackAt(const int32 &index) const
+		{ return index >= 0 && index < CountPacks() ? fList[index] : NULL; }
+	int32 CountPacks(void) const { return fList.size(); }
+	status_t AddPack(const char* path);
+	void AddPack(PuzzlePack* pack);
+
+private:
+	std::vector<PuzzlePack*> fList;
+};
+
+#endif
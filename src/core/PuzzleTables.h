@@ -0,0 +1,156 @@
+#ifndef PUZZLE_TABLES_H
+#define PUZZLE_TABLES_H
+
+#include "CoreDefs.h"
+
+// Tables of every puzzle of a small dimension that takes exactly a given
+// number of moves, worked out by the compiler. DistanceTable<n> walks all
+// 2^(n*n) press sets in Gray code order, one press per step, and keeps the
+// fewest presses that reach each board; PuzzleTable<n, moves> then collects
+// the boards at that distance in increasing order. Both are constexpr, so
+// the tables end up in the binary as constant data with no startup cost.
+// PuzzleTableList<n> instantiates one table for every solvable distance of
+// the dimension and finds the one for a given number of moves.
+//
+// The distance table has one entry per board, which limits this to 4x4.
+
+template<int Dimension>
+struct DistanceTable {
+	enum {
+		kNumButtons = Dimension * Dimension,
+		kNumBoards = 1 << kNumButtons,
+		kUnsolvable = 0xff
+	};
+
+	static_assert(kNumButtons <= 16, "too many boards for a constexpr table");
+
+	uint8 moves[kNumBoards];
+
+	constexpr DistanceTable()
+		:
+		moves()
+	{
+		for (int32 board = 0; board < kNumBoards; board++)
+			moves[board] = kUnsolvable;
+
+		uint32 board = 0;
+		moves[0] = 0;
+
+		for (uint32 step = 1; step < (uint32) kNumBoards; step++) {
+			const int32 button = __builtin_ctz(step);
+			board ^= PressMask(button);
+
+			const uint32 presses = step ^ (step >> 1);
+			const uint8 count = __builtin_popcount(presses);
+			if (count < moves[board])
+				moves[board] = count;
+		}
+	}
+
+	static constexpr uint32 PressMask(int32 button)
+	{
+		const int32 n = Dimension;
+		uint32 mask = (uint32) 1 << button;
+
+		if (button % n)	// not leftmost column
+			mask |= (uint32) 1 << (button - 1);
+		if ((button + 1) % n)	// not rightmost column
+			mask |= (uint32) 1 << (button + 1);
+		if (button >= n)	// not top row
+			mask |= (uint32) 1 << (button - n);
+		if (button < n * (n - 1))	// not bottom row
+			mask |= (uint32) 1 << (button + n);
+
+		return mask;
+	}
+
+	constexpr int32 MaxMoves() const
+	{
+		int32 maxMoves = 0;
+
+		for (int32 board = 0; board < kNumBoards; board++)
+			if (moves[board] != kUnsolvable && moves[board] > maxMoves)
+				maxMoves = moves[board];
+
+		return maxMoves;
+	}
+
+	constexpr int32 CountBoards(int32 count) const
+	{
+		int32 boards = 0;
+
+		for (int32 board = 0; board < kNumBoards; board++)
+			if (moves[board] == count)
+				boards++;
+
+		return boards;
+	}
+};
+
+
+template<int Dimension>
+constexpr DistanceTable<Dimension> kDistanceTable = DistanceTable<Dimension>();
+
+
+template<int Dimension, int Moves>
+struct PuzzleTable {
+	enum { kCount = kDistanceTable<Dimension>.CountBoards(Moves) };
+
+	static_assert(kCount > 0, "no puzzles take that many moves");
+
+	uint16 puzzles[kCount];
+
+	constexpr PuzzleTable()
+		:
+		puzzles()
+	{
+		int32 count = 0;
+
+		for (int32 board = 0; board < DistanceTable<Dimension>::kNumBoards;
+				board++)
+			if (kDistanceTable<Dimension>.moves[board] == Moves)
+				puzzles[count++] = board;
+	}
+};
+
+
+template<int Dimension, int Moves>
+constexpr PuzzleTable<Dimension, Moves> kPuzzleTable
+	= PuzzleTable<Dimension, Moves>();
+
+
+struct puzzle_table_entry {
+	const uint16*	puzzles;
+	int32			count;
+};
+
+
+template<int Dimension, int Moves = 1,
+	bool IsLast = Moves >= kDistanceTable<Dimension>.MaxMoves()>
+struct PuzzleTableList {
+	enum { kMaxMoves = kDistanceTable<Dimension>.MaxMoves() };
+
+	static constexpr puzzle_table_entry At(int32 moves)
+	{
+		return moves == Moves
+			? puzzle_table_entry{ kPuzzleTable<Dimension, Moves>.puzzles,
+				PuzzleTable<Dimension, Moves>::kCount }
+			: PuzzleTableList<Dimension, Moves + 1>::At(moves);
+	}
+};
+
+
+template<int Dimension, int Moves>
+struct PuzzleTableList<Dimension, Moves, true> {
+	enum { kMaxMoves = Moves };
+
+	static constexpr puzzle_table_entry At(int32 moves)
+	{
+		return moves == Moves
+			? puzzle_table_entry{ kPuzzleTable<Dimension, Moves>.puzzles,
+				PuzzleTable<Dimension, Moves>::kCount }
+			: puzzle_table_entry{ NULL, 0 };
+	}
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2018 Haiku, Inc.
+ * Distributed under the terms of the MIT License.
+ *
+ * Author:
+ *			Owen Pan <owen.pan@yahoo.com>
+ */
+
+#include "Random.h"
+
+#include <atomic>
+
+// the stream the next thread to call RandomGenerator::ForThread() gets
+static std::atomic<uint64> sNextStream(0);
+
+
+static uint64
+SplitMix64(uint64& state)
+{
+	uint64 result = (state += 0x9e3779b97f4a7c15ULL);
+	result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	result = (result ^ (result >> 27)) * 0x94d049bb133111ebULL;
+	return result ^ (result >> 31);
+}
+
+
+RandomGenerator::RandomGenerator(uint64 seed, uint64 stream)
+{
+	Seed(seed, stream);
+}
+
+
+/*
+ * Start the sequence of seed at stream. The cost grows with stream, one
+ * Jump() per stream number before it.
+ */
+
+void
+RandomGenerator::Seed(uint64 seed, uint64 stream)
+{
+	for (int index = 0; index < 4; index++)
+		fState[index] = SplitMix64(seed);
+
+	for (uint64 jump = 0; jump < stream; jump++)
+		Jump();
+}
+
+
+/*
+ * Skip 2^128 numbers ahead, which takes as long as drawing 256 of them.
+ */
+
+void
+RandomGenerator::Jump()
+{
+	static const uint64 polynomial[4] = {
+		0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+		0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+	};
+
+	uint64 state[4] = { 0, 0, 0, 0 };
+
+	for (int word = 0; word < 4; word++) {
+		for (int bit = 0; bit < 64; bit++) {
+			if (polynomial[word] & ((uint64) 1 << bit)) {
+				for (int index = 0; index < 4; index++)
+					state[index] ^= fState[index];
+			}
+			Next();
+		}
+	}
+
+	for (int index = 0; index < 4; index++)
+		fState[index] = state[index];
+}
+
+
+RandomGenerator&
+RandomGenerator::ForThread()
+{
+	static thread_local RandomGenerator generator(0, sNextStream++);
+	return generator;
+}
@@ -0,0 +1,73 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include "CoreDefs.h"
+
+// The RandomGenerator class is xoshiro256**: 256 bits of state, a handful of
+// shifts, rotates and XORs per number, and a period of 2^256 - 1. Unlike
+// random(), every generator has its own state, so threads don't contend for
+// a lock and the numbers depend only on the seed.
+//
+// A seed is spread over the state with splitmix64. Generators with the same
+// seed but different streams are 2^128 numbers apart in the same sequence,
+// so they never overlap; that is what parallel jobs should use to stay
+// reproducible. Seed() gets to a stream by jumping once per stream number,
+// about 1.6 us each, which suits one stream per thread; to hand out many
+// streams, Jump() a copy of one generator once for each new stream instead.
+// ForThread() is the default for callers that don't pass a generator of
+// their own: one per thread, which stream it gets depending on the order in
+// which the threads first ask for it.
+
+class RandomGenerator
+{
+public:
+	RandomGenerator(uint64 seed = 0, uint64 stream = 0);
+
+	void Seed(uint64 seed, uint64 stream = 0);
+
+	uint64 Next()
+	{
+		const uint64 result = _Rotate(fState[1] * 5, 7) * 9;
+		const uint64 shifted = fState[1] << 17;
+
+		fState[2] ^= fState[0];
+		fState[3] ^= fState[1];
+		fState[1] ^= fState[2];
+		fState[0] ^= fState[3];
+		fState[2] ^= shifted;
+		fState[3] = _Rotate(fState[3], 45);
+
+		return result;
+	}
+
+	/*
+	 * A number in [0, bound), each equally likely. The high half of Next()
+	 * is scaled to the range by a multiplication, and the few products that
+	 * would favour some numbers over others are drawn again (Lemire's
+	 * method), which is rarely needed and never divides in the common case.
+	 */
+	uint32 Uniform(uint32 bound)
+	{
+		uint64 product = (Next() >> 32) * bound;
+
+		if ((uint32) product < bound) {
+			const uint32 threshold = -bound % bound;
+			while ((uint32) product < threshold)
+				product = (Next() >> 32) * bound;
+		}
+
+		return product >> 32;
+	}
+
+	void Jump();
+
+	static RandomGenerator& ForThread();
+
+private:
+	static uint64 _Rotate(uint64 value, int shift)
+		{ return (value << shift) | (value >> (64 - shift)); }
+
+	uint64 fState[4];
+};
+
+#endif
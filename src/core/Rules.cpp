@@ -0,0 +1,67 @@
+#include "Rules.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+static const int8 maxDimension = 8;
+
+// leftmost column of an n by n grid for n = 0..8, one bit per row
+static const uint64 leftColumns[maxDimension + 1] = {
+	0x0000000000000000ULL, 0x0000000000000001ULL, 0x0000000000000005ULL,
+	0x0000000000000049ULL, 0x0000000000001111ULL, 0x0000000000108421ULL,
+	0x0000000041041041ULL, 0x0000040810204081ULL, 0x0101010101010101ULL
+};
+
+static const char* shapeNames[kNumNeighbourhoods] = { "plus", "x", "moore" };
+
+
+rule_geometry::rule_geometry(int8 dimension)
+	:
+	dimension(dimension)
+{
+	assert(dimension > 0 && dimension <= maxDimension);
+
+	const int8 numButtons = dimension * dimension;
+	fullMask = numButtons >= 64 ? ~(uint64) 0
+		: ((uint64) 1 << numButtons) - 1;
+	leftColumn = leftColumns[dimension];
+	rightColumn = leftColumn << (dimension - 1);
+	topRow = ((uint64) 1 << dimension) - 1;
+	bottomRow = topRow << (numButtons - dimension);
+}
+
+
+Rules::Rules(neighbourhood shape, bool toroidal)
+	:
+	fShape(shape),
+	fToroidal(toroidal)
+{
+	assert(shape >= 0 && shape < kNumNeighbourhoods);
+
+	static const spread_function spreadFunctions[kNumNeighbourhoods][2] = {
+		{ RuleKernel<kPlusNeighbourhood, false>::Spread,
+			RuleKernel<kPlusNeighbourhood, true>::Spread },
+		{ RuleKernel<kXNeighbourhood, false>::Spread,
+			RuleKernel<kXNeighbourhood, true>::Spread },
+		{ RuleKernel<kMooreNeighbourhood, false>::Spread,
+			RuleKernel<kMooreNeighbourhood, true>::Spread }
+	};
+
+	fSpread = spreadFunctions[shape][toroidal];
+
+	// "plus", "moore-torus", ...
+	snprintf(fName, sizeof(fName), "%s%s", shapeNames[shape],
+		toroidal ? "-torus" : "");
+}
+
+uint64 Rules::PressMask(int8 dimension, int8 offset) const
+{
+	assert(!fToroidal || dimension >= 3);
+
+	return fSpread(rule_geometry(dimension), (uint64) 1 << offset);
+}
+
+bool Rules::operator==(const Rules& other) const
+{
+	return fShape == other.fShape && fToroidal == other.fToroidal;
+}
@@ -0,0 +1,150 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include "CoreDefs.h"
+
+// The Rules class describes what a button press does on grids up to 8x8, in
+// the bitboard layout of Grid: which neighbours it toggles and whether the
+// grid wraps around at its edges. Lights only have two states here; boards
+// whose lights cycle through more are ModularBoard's.
+//
+// Every combination of neighbourhood and wraparound has its own kernel,
+// RuleKernel<Shape, Toroidal>, which works out the lights toggled by a whole
+// set of presses at once with a few shifts and masks. Pressing is linear, so
+// the lights toggled by a set of buttons are the XOR of those toggled by
+// each, and one kernel call covers both a single press and a whole solution.
+// Rules picks the kernel when it is created; Grid calls the classic one
+// directly, so the standard game doesn't pay for the indirection.
+//
+// Toroidal grids must be at least 3x3, where the neighbours of a button are
+// all different lights.
+
+enum neighbourhood {
+	kPlusNeighbourhood = 0,	// the button and the four lights beside it
+	kXNeighbourhood,		// the button and its four diagonal neighbours
+	kMooreNeighbourhood,	// the button and all eight lights around it
+	kNumNeighbourhoods
+};
+
+
+struct rule_geometry {
+	rule_geometry(int8 dimension = 1);
+
+	int8	dimension;
+	uint64	fullMask;
+	uint64	leftColumn;
+	uint64	rightColumn;
+	uint64	topRow;
+	uint64	bottomRow;
+};
+
+
+template<bool Toroidal>
+struct RuleShifts {
+	// every light moved one step right, left, up or down; lights that leave
+	// the grid are dropped or, on a torus, come back in on the other side
+	static uint64 East(const rule_geometry& geometry, uint64 lights)
+	{
+		uint64 moved = (lights & ~geometry.rightColumn) << 1;
+		if (Toroidal) {
+			moved |= (lights & geometry.rightColumn)
+				>> (geometry.dimension - 1);
+		}
+		return moved;
+	}
+
+	static uint64 West(const rule_geometry& geometry, uint64 lights)
+	{
+		uint64 moved = (lights & ~geometry.leftColumn) >> 1;
+		if (Toroidal) {
+			moved |= (lights & geometry.leftColumn)
+				<< (geometry.dimension - 1);
+		}
+		return moved;
+	}
+
+	static uint64 North(const rule_geometry& geometry, uint64 lights)
+	{
+		uint64 moved = lights >> geometry.dimension;
+		if (Toroidal) {
+			moved |= (lights & geometry.topRow)
+				<< (geometry.dimension * (geometry.dimension - 1));
+		}
+		return moved;
+	}
+
+	static uint64 South(const rule_geometry& geometry, uint64 lights)
+	{
+		uint64 moved = (lights & ~geometry.bottomRow) << geometry.dimension;
+		if (Toroidal) {
+			moved |= (lights & geometry.bottomRow)
+				>> (geometry.dimension * (geometry.dimension - 1));
+		}
+		return moved;
+	}
+};
+
+
+template<int Shape, bool Toroidal>
+struct RuleKernel {
+	typedef RuleShifts<Toroidal> Shifts;
+
+	// the lights toggled by pressing every button set in presses
+	static uint64 Spread(const rule_geometry& geometry, uint64 presses)
+	{
+		uint64 lights = presses;
+		const uint64 vertical = Shifts::North(geometry, presses)
+			^ Shifts::South(geometry, presses);
+
+		if (Shape != kXNeighbourhood) {
+			lights ^= vertical ^ Shifts::East(geometry, presses)
+				^ Shifts::West(geometry, presses);
+		}
+
+		if (Shape != kPlusNeighbourhood) {
+			lights ^= Shifts::East(geometry, vertical)
+				^ Shifts::West(geometry, vertical);
+		}
+
+		return lights;
+	}
+
+	static uint64 PressMask(const rule_geometry& geometry, int8 offset)
+	{
+		return Spread(geometry, (uint64) 1 << offset);
+	}
+};
+
+typedef RuleKernel<kPlusNeighbourhood, false> ClassicRule;
+
+
+class Rules
+{
+public:
+	Rules(neighbourhood shape = kPlusNeighbourhood, bool toroidal = false);
+
+	neighbourhood Shape() const { return fShape; }
+	bool IsToroidal() const { return fToroidal; }
+	bool IsClassic() const
+		{ return fShape == kPlusNeighbourhood && !fToroidal; }
+
+	const char* Name() const { return fName; }
+
+	uint64 Spread(const rule_geometry& geometry, uint64 presses) const
+		{ return fSpread(geometry, presses); }
+	uint64 PressMask(int8 dimension, int8 offset) const;
+
+	bool operator==(const Rules& other) const;
+	bool operator!=(const Rules& other) const { return !(*this == other); }
+
+private:
+	typedef uint64 (*spread_function)(const rule_geometry& geometry,
+		uint64 presses);
+
+	neighbourhood fShape;
+	bool fToroidal;
+	spread_function fSpread;
+	char fName[32];
+};
+
+#endif
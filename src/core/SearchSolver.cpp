@@ -0,0 +1,444 @@
+#include "SearchSolver.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "Grid.h"
+#include "Rules.h"
+
+// levels with less work than this stay on the calling thread, as starting
+// threads would take longer than the work
+static const size_t minParallelStates = 16384;
+
+static const size_t initialTableSize = 1024;
+static const uint8 noMove = 0xff;
+
+
+// An open-addressing hash set of boards with linear probing, mapping each
+// board to the move that first reached it. Insert() may run on several
+// threads at once: a slot is claimed by a compare-and-swap on its key, and
+// the move is only read once all of them are done. Growing the table is
+// left to the caller, between levels, as is counting what's in it.
+//
+// Empty slots hold the all-ones board, which is a real board on 8x8 and so
+// is tracked on its own.
+
+class SearchSolver::StateTable
+{
+public:
+	StateTable()
+		:
+		fKeys(NULL),
+		fMoves(NULL),
+		fMask(0),
+		fCount(0),
+		fHasEmptyKey(false),
+		fEmptyKeyMove(noMove)
+	{
+	}
+
+	bool Init(Arena& arena, size_t size)
+	{
+		fKeys = NULL;
+		fMask = 0;
+		fCount = 0;
+		fHasEmptyKey = false;
+		fEmptyKeyMove = noMove;
+
+		return _Allocate(arena, size);
+	}
+
+	// make sure count more boards can be added at a load of at most a half
+	bool Reserve(Arena& arena, size_t count)
+	{
+		size_t size = fMask + 1;
+		while ((fCount + count) * 2 > size)
+			size *= 2;
+
+		if (size == fMask + 1)
+			return true;
+
+		uint64* keys = fKeys;
+		uint8* moves = fMoves;
+		const size_t oldSize = fMask + 1;
+
+		if (!_Allocate(arena, size))
+			return false;
+
+		// the old arrays stay in the arena until the next solve
+		for (size_t slot = 0; slot < oldSize; slot++)
+			if (keys[slot] != kEmpty)
+				_Put(keys[slot], moves[slot]);
+
+		return true;
+	}
+
+	bool Contains(uint64 board) const
+	{
+		if (board == kEmpty)
+			return fHasEmptyKey;
+
+		for (size_t slot = Grid::HashBoard(board) & fMask;;
+				slot = (slot + 1) & fMask) {
+			const uint64 key = __atomic_load_n(&fKeys[slot], __ATOMIC_RELAXED);
+			if (key == board)
+				return true;
+			if (key == kEmpty)
+				return false;
+		}
+	}
+
+	// true if the board wasn't in the table before
+	bool Insert(uint64 board, uint8 move)
+	{
+		if (board == kEmpty) {
+			if (__atomic_exchange_n(&fHasEmptyKey, true, __ATOMIC_RELAXED))
+				return false;
+
+			fEmptyKeyMove = move;
+			return true;
+		}
+
+		for (size_t slot = Grid::HashBoard(board) & fMask;;
+				slot = (slot + 1) & fMask) {
+			uint64 key = kEmpty;
+			if (__atomic_compare_exchange_n(&fKeys[slot], &key, board, false,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				fMoves[slot] = move;
+				return true;
+			}
+
+			if (key == board)
+				return false;
+		}
+	}
+
+	uint8 MoveFor(uint64 board) const
+	{
+		if (board == kEmpty)
+			return fEmptyKeyMove;
+
+		size_t slot = Grid::HashBoard(board) & fMask;
+		while (fKeys[slot] != board)
+			slot = (slot + 1) & fMask;
+
+		return fMoves[slot];
+	}
+
+	size_t Count() const { return fCount; }
+	void Added(size_t count) { fCount += count; }
+
+private:
+	static const uint64 kEmpty = ~(uint64) 0;
+
+	bool _Allocate(Arena& arena, size_t size)
+	{
+		uint64* keys = arena.Allocate<uint64>(size);
+		uint8* moves = arena.Allocate<uint8>(size);
+		if (keys == NULL || moves == NULL)
+			return false;
+
+		memset(keys, 0xff, size * sizeof(uint64));
+		fKeys = keys;
+		fMoves = moves;
+		fMask = size - 1;
+		return true;
+	}
+
+	void _Put(uint64 board, uint8 move)
+	{
+		size_t slot = Grid::HashBoard(board) & fMask;
+		while (fKeys[slot] != kEmpty)
+			slot = (slot + 1) & fMask;
+
+		fKeys[slot] = board;
+		fMoves[slot] = move;
+	}
+
+	uint64* fKeys;
+	uint8* fMoves;
+	size_t fMask;
+	size_t fCount;
+	bool fHasEmptyKey;
+	uint8 fEmptyKeyMove;
+};
+
+
+struct SearchSolver::search_side {
+	StateTable				table;
+	std::vector<uint64>		frontier;
+	bool					forward;
+};
+
+
+SearchSolver::SearchSolver(int8 dimension, int32 numThreads)
+	:
+	SearchSolver(dimension, Rules(), numThreads)
+{
+}
+
+SearchSolver::SearchSolver(int8 dimension, const Rules& rules,
+	int32 numThreads)
+	:
+	fDimension(dimension)
+{
+	assert(dimension > 0 && dimension <= 8);
+
+	for (int8 offset = 0; offset < dimension * dimension; offset++)
+		fMoves.push_back(rules.PressMask(dimension, offset));
+
+	_Init(numThreads);
+}
+
+SearchSolver::SearchSolver(int8 dimension, const std::vector<uint64>& moves,
+	int32 numThreads)
+	:
+	fDimension(dimension),
+	fMoves(moves)
+{
+	assert(dimension > 0 && dimension <= 8);
+	assert(moves.size() < noMove);
+
+	_Init(numThreads);
+}
+
+SearchSolver::~SearchSolver()
+{
+	delete fForward;
+	delete fBackward;
+}
+
+void SearchSolver::_Init(int32 numThreads)
+{
+	if (numThreads < 1)
+		numThreads = std::thread::hardware_concurrency();
+	if (numThreads < 1)
+		numThreads = 1;
+
+	fNumThreads = numThreads;
+	fStateLimit = kDefaultStateLimit;
+	fStatesVisited = 0;
+
+	fForward = new search_side;
+	fForward->forward = true;
+	fBackward = new search_side;
+	fBackward->forward = false;
+
+	fCandidates.resize(numThreads);
+	fCandidateMoves.resize(numThreads);
+	fNextFrontiers.resize(numThreads);
+}
+
+/*
+ * A shortest sequence of moves that turns every light off, as indices into
+ * the move list (for the default moves, the buttons to pass to
+ * Grid::Press()). Returns B_ERROR if there is none and B_NO_MEMORY if the
+ * search got too large before finding one.
+ */
+
+status_t SearchSolver::Solve(uint64 lights, std::vector<uint8>& moves)
+{
+	moves.clear();
+	fStatesVisited = 0;
+
+	if (lights == 0)
+		return B_OK;
+
+	fArena.Reset();
+
+	if (!fForward->table.Init(fArena, initialTableSize)
+		|| !fBackward->table.Init(fArena, initialTableSize))
+		return B_NO_MEMORY;
+
+	fForward->table.Insert(lights, noMove);
+	fForward->table.Added(1);
+	fForward->frontier.assign(1, lights);
+
+	fBackward->table.Insert(0, noMove);
+	fBackward->table.Added(1);
+	fBackward->frontier.assign(1, 0);
+
+	fMet = false;
+
+	while (!fMet) {
+		search_side& side = fForward->frontier.size()
+			<= fBackward->frontier.size() ? *fForward : *fBackward;
+		search_side& other = &side == fForward ? *fBackward : *fForward;
+
+		// one side ran out of boards without reaching the other
+		if (side.frontier.empty())
+			return B_ERROR;
+
+		if (side.table.Count() + other.table.Count() > fStateLimit)
+			return B_NO_MEMORY;
+
+		status_t status = _Expand(side, other);
+		if (status != B_OK)
+			return status;
+	}
+
+	// walk back from where the searches met to the board, then on to the
+	// empty board
+	uint64 state = fMeetForward;
+	for (uint8 move; (move = fForward->table.MoveFor(state)) != noMove;
+			state ^= fMoves[move])
+		moves.push_back(move);
+
+	std::reverse(moves.begin(), moves.end());
+	moves.push_back(fMeetMove);
+
+	state = fMeetBackward;
+	for (uint8 move; (move = fBackward->table.MoveFor(state)) != noMove;
+			state ^= fMoves[move])
+		moves.push_back(move);
+
+	return B_OK;
+}
+
+status_t SearchSolver::Solve(const Grid& grid, std::vector<uint8>& moves)
+{
+	assert(grid.Dimension() == fDimension);
+
+	return Solve(grid.GetGridValues(), moves);
+}
+
+/*
+ * The length of a shortest solution, or -1 if there is none or it couldn't
+ * be found within the state limit.
+ */
+
+int32 SearchSolver::MinimumMoves(uint64 lights)
+{
+	std::vector<uint8> moves;
+	if (Solve(lights, moves) != B_OK)
+		return -1;
+
+	return moves.size();
+}
+
+/*
+ * Take the search on one side a level deeper. Every board of the new level
+ * is checked against the other side first; the first level with a board in
+ * common gives a shortest solution, as all shorter ones would have met on an
+ * earlier level.
+ */
+
+status_t SearchSolver::_Expand(search_side& side, search_side& other)
+{
+	const size_t count = side.frontier.size();
+	const size_t chunk = (count + fNumThreads - 1) / fNumThreads;
+
+	_RunThreads(count >= minParallelStates, [&](int32 thread) {
+		const size_t first = std::min(thread * chunk, count);
+		const size_t end = std::min(first + chunk, count);
+		_Generate(thread, first, end, &side, &other);
+	});
+
+	if (fMet)
+		return B_OK;
+
+	size_t numCandidates = 0;
+	for (int32 thread = 0; thread < fNumThreads; thread++)
+		numCandidates += fCandidates[thread].size();
+
+	if (!side.table.Reserve(fArena, numCandidates))
+		return B_NO_MEMORY;
+
+	_RunThreads(numCandidates >= minParallelStates, [&](int32 thread) {
+		_Insert(thread, &side);
+	});
+
+	side.frontier.clear();
+	for (int32 thread = 0; thread < fNumThreads; thread++) {
+		side.frontier.insert(side.frontier.end(),
+			fNextFrontiers[thread].begin(), fNextFrontiers[thread].end());
+	}
+
+	side.table.Added(side.frontier.size());
+	fStatesVisited += side.frontier.size();
+
+	return B_OK;
+}
+
+/*
+ * Collect the boards one move away from frontier boards [first, end) that
+ * this side hasn't seen yet, and look for them on the other side. Nothing
+ * is added to either table here, so the lookups need no locking.
+ */
+
+void SearchSolver::_Generate(int32 thread, size_t first, size_t end,
+	const search_side* side, const search_side* other)
+{
+	std::vector<uint64>& candidates = fCandidates[thread];
+	std::vector<uint8>& candidateMoves = fCandidateMoves[thread];
+	candidates.clear();
+	candidateMoves.clear();
+
+	const int32 numMoves = fMoves.size();
+
+	for (size_t index = first; index < end; index++) {
+		const uint64 state = side->frontier[index];
+
+		for (int32 move = 0; move < numMoves; move++) {
+			const uint64 next = state ^ fMoves[move];
+			if (side->table.Contains(next))
+				continue;
+
+			if (other->table.Contains(next)) {
+				std::lock_guard<std::mutex> lock(fMeetLock);
+				if (!fMet) {
+					fMet = true;
+					fMeetForward = side->forward ? state : next;
+					fMeetBackward = side->forward ? next : state;
+					fMeetMove = move;
+				}
+				return;
+			}
+
+			candidates.push_back(next);
+			candidateMoves.push_back(move);
+		}
+	}
+}
+
+/*
+ * Add the boards one thread collected to the table; those that weren't
+ * there yet, from this or any other thread, make up the next frontier.
+ */
+
+void SearchSolver::_Insert(int32 thread, search_side* side)
+{
+	const std::vector<uint64>& candidates = fCandidates[thread];
+	const std::vector<uint8>& candidateMoves = fCandidateMoves[thread];
+	std::vector<uint64>& next = fNextFrontiers[thread];
+	next.clear();
+
+	for (size_t index = 0; index < candidates.size(); index++)
+		if (side->table.Insert(candidates[index], candidateMoves[index]))
+			next.push_back(candidates[index]);
+}
+
+/*
+ * Call function(thread) for every thread index, on that many threads if the
+ * work is worth it and one after the other on this one if not.
+ */
+
+template<typename Function>
+void SearchSolver::_RunThreads(bool parallel, Function function)
+{
+	if (!parallel || fNumThreads == 1) {
+		for (int32 thread = 0; thread < fNumThreads; thread++)
+			function(thread);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	for (int32 thread = 0; thread < fNumThreads; thread++)
+		workers.push_back(std::thread(function, thread));
+
+	for (size_t index = 0; index < workers.size(); index++)
+		workers[index].join();
+}
@@ -0,0 +1,98 @@
+#ifndef SEARCH_SOLVER_H
+#define SEARCH_SOLVER_H
+
+#include <mutex>
+#include <vector>
+
+#include "Arena.h"
+#include "CoreDefs.h"
+
+class Grid;
+class Rules;
+
+// The SearchSolver class finds a shortest move sequence by searching the
+// board states themselves, for rules where linear algebra doesn't apply. It
+// runs a breadth-first search from the board and another from the empty
+// board, one level at a time and always on the side with the smaller
+// frontier, until a state turns up on both sides. A solution of k moves then
+// costs about two searches of depth k / 2 instead of one of depth k.
+//
+// A move is given as the mask of lights it toggles, so any set of up to 254
+// button patterns can be searched; by default they are the button presses
+// of the classic Rules, or of other two-state ones. Solutions are returned
+// as indices into that list. The visited states of each side live in an
+// open-addressing hash table that threads fill without locks, and the
+// tables are allocated from an arena kept from one solve to the next. Large
+// frontiers are expanded on every core.
+//
+// The state space grows exponentially with the solution length. On the
+// standard rules a 10 move 5x5 puzzle takes some 50 ms on one core and the
+// hardest ones (15 moves) less than two seconds. A board that can't be
+// solved is only recognized once every board reachable from it has been
+// visited, so on the standard rules Solver should rule those out first.
+// Solve() gives up with B_NO_MEMORY once the tables hold StateLimit()
+// boards.
+
+class SearchSolver
+{
+public:
+	enum { kDefaultStateLimit = 1 << 23 };
+
+	SearchSolver(int8 dimension, int32 numThreads = 0);
+	SearchSolver(int8 dimension, const Rules& rules, int32 numThreads = 0);
+	SearchSolver(int8 dimension, const std::vector<uint64>& moves,
+		int32 numThreads = 0);
+	~SearchSolver();
+
+	int8 Dimension() const { return fDimension; }
+	int32 CountMoves() const { return fMoves.size(); }
+	uint64 MoveMask(int32 move) const { return fMoves[move]; }
+
+	uint64 StateLimit() const { return fStateLimit; }
+	void SetStateLimit(uint64 limit) { fStateLimit = limit; }
+
+	status_t Solve(uint64 lights, std::vector<uint8>& moves);
+	status_t Solve(const Grid& grid, std::vector<uint8>& moves);
+	int32 MinimumMoves(uint64 lights);
+
+	uint64 StatesVisited() const { return fStatesVisited; }
+
+private:
+	class StateTable;
+	struct search_side;
+
+	void _Init(int32 numThreads);
+	status_t _Expand(search_side& side, search_side& other);
+	void _Generate(int32 thread, size_t first, size_t end,
+		const search_side* side, const search_side* other);
+	void _Insert(int32 thread, search_side* side);
+
+	template<typename Function>
+	void _RunThreads(bool parallel, Function function);
+
+	int8 fDimension;
+	std::vector<uint64> fMoves;
+	int32 fNumThreads;
+	uint64 fStateLimit;
+	uint64 fStatesVisited;
+
+	Arena fArena;
+	search_side* fForward;
+	search_side* fBackward;
+
+	// per thread: the new boards found on a level and the move that reached
+	// each of them, and which of those were really new
+	std::vector<std::vector<uint64> > fCandidates;
+	std::vector<std::vector<uint8> > fCandidateMoves;
+	std::vector<std::vector<uint64> > fNextFrontiers;
+
+	// where the two searches touched: meetForward was reached from the board,
+	// meetBackward from the empty board, and meetMove turns one into the other
+	std::mutex fMeetLock;
+	bool fMet;
+	uint64 fMeetForward;
+	uint64 fMeetBackward;
+	uint8 fMeetMove;
+};
+
+#endif
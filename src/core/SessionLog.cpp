@@ -0,0 +1,312 @@
+#include "SessionLog.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+static const char magic[8] = { 'L', 'O', 'S', 'E', 'S', 'S', 'I', 'O' };
+
+// a pack puzzle may take this many moves more than it requires
+static const int32 extraMoves = 10;
+
+
+/*
+ * How a puzzle solved in moves moves ends: random puzzles, which pass -1 as
+ * movesRequired, always count, but a pack puzzle has to be solved within
+ * extraMoves of what PuzzlePack::MovesRequired() says it requires.
+ */
+
+session_outcome
+FinishOutcome(int32 movesRequired, int32 moves)
+{
+	if (movesRequired >= 0 && moves > movesRequired + extraMoves)
+		return kTooManyMovesOutcome;
+
+	return kSolvedOutcome;
+}
+
+
+/*
+ * Remove all but the newest keep logs from directory, going by their names.
+ * Files not named after a time are left alone.
+ */
+
+status_t
+PruneSessionLogs(const char* directory, int32 keep)
+{
+	DIR* dir = opendir(directory);
+	if (dir == NULL)
+		return B_FROM_POSIX_ERROR(errno);
+
+	std::vector<std::pair<int64, std::string> > logs;
+
+	while (struct dirent* dirent = readdir(dir)) {
+		const char* name = dirent->d_name;
+		char* end;
+		const int64 started = strtoll(name, &end, 10);
+
+		if (name[0] >= '0' && name[0] <= '9' && *end == '\0')
+			logs.push_back(std::make_pair(started, std::string(name)));
+	}
+
+	closedir(dir);
+	std::sort(logs.begin(), logs.end());
+
+	status_t status = B_OK;
+
+	for (size_t index = 0; index + keep < logs.size(); index++) {
+		const std::string path
+			= std::string(directory) + "/" + logs[index].second;
+		if (unlink(path.c_str()) != 0)
+			status = B_FROM_POSIX_ERROR(errno);
+	}
+
+	return status;
+}
+
+
+SessionRecorder::SessionRecorder()
+	:
+	fFile(NULL)
+{
+	Reset();
+}
+
+SessionRecorder::~SessionRecorder()
+{
+	Close();
+}
+
+/*
+ * Write the log to path from now on, starting with what has been recorded
+ * so far.
+ */
+
+status_t SessionRecorder::Open(const char* path)
+{
+	Close();
+
+	fFile = fopen(path, "wb");
+	if (fFile == NULL)
+		return B_FROM_POSIX_ERROR(errno);
+
+	// the header went to an earlier file, and this one needs its own
+	if (fHeaderSize == 0) {
+		fData.insert(fData.begin(), SessionReader::kVersion);
+		fData.insert(fData.begin(), magic, magic + sizeof(magic));
+		fHeaderSize = sizeof(magic) + 1;
+	}
+
+	return Flush();
+}
+
+void SessionRecorder::Close()
+{
+	if (fFile == NULL)
+		return;
+
+	Flush();
+	fclose(fFile);
+	fFile = NULL;
+}
+
+status_t SessionRecorder::Flush()
+{
+	if (fFile == NULL) {
+		// the header is kept for the file Open() may still be given
+		fData.resize(fHeaderSize);
+		return B_OK;
+	}
+
+	if (fData.empty())
+		return B_OK;
+
+	if (fwrite(&fData[0], 1, fData.size(), fFile) != fData.size()
+		|| fflush(fFile) != 0)
+		return B_FROM_POSIX_ERROR(errno);
+
+	fData.clear();
+	fHeaderSize = 0;
+	return B_OK;
+}
+
+/*
+ * Start a new log in memory, keeping the buffer for it.
+ */
+
+void SessionRecorder::Reset()
+{
+	fData.clear();
+	fData.insert(fData.end(), magic, magic + sizeof(magic));
+	fData.push_back(SessionReader::kVersion);
+	fHeaderSize = fData.size();
+	fLastTime = 0;
+}
+
+void SessionRecorder::StartPuzzle(int64 time, int8 dimension,
+	const char* pack, int32 level, uint32 seed, uint64 board)
+{
+	const size_t length = pack != NULL ? strlen(pack) : 0;
+
+	_AddHeader(time, kPuzzleEvent);
+	_AddVarint(dimension);
+	_AddVarint(length);
+	fData.insert(fData.end(), pack, pack + length);
+	_AddVarint(level);
+	_AddVarint(seed);
+	_AddVarint(board);
+}
+
+void SessionRecorder::AddPress(int64 time, int8 button)
+{
+	_AddHeader(time, kPressEvent + button);
+}
+
+void SessionRecorder::AddEvent(int64 time, session_event_type type)
+{
+	_AddHeader(time, type);
+}
+
+void SessionRecorder::Finish(int64 time, int32 moves, session_outcome outcome)
+{
+	_AddHeader(time, kFinishEvent);
+	_AddVarint(moves);
+	_AddVarint(outcome);
+}
+
+void SessionRecorder::_AddHeader(int64 time, uint8 type)
+{
+	int64 milliseconds = time / 1000;
+	if (milliseconds < fLastTime)
+		milliseconds = fLastTime;
+
+	fData.push_back(type);
+	_AddVarint(milliseconds - fLastTime);
+	fLastTime = milliseconds;
+}
+
+void SessionRecorder::_AddVarint(uint64 value)
+{
+	while (value >= 0x80) {
+		fData.push_back((uint8) value | 0x80);
+		value >>= 7;
+	}
+
+	fData.push_back((uint8) value);
+}
+
+
+SessionReader::SessionReader(const uint8* data, size_t size)
+	:
+	fData(data),
+	fSize(size),
+	fPosition(sizeof(magic) + 1),
+	fLastTime(0),
+	fStatus(B_OK)
+{
+	if (size < sizeof(magic) + 1 || memcmp(data, magic, sizeof(magic)) != 0
+		|| data[sizeof(magic)] != kVersion)
+		fStatus = B_BAD_DATA;
+}
+
+bool SessionReader::Next(session_event& event)
+{
+	if (fStatus != B_OK || fPosition == fSize)
+		return false;
+
+	const uint8 type = fData[fPosition++];
+	uint64 delta;
+	if (!_ReadVarint(delta)) {
+		fStatus = B_BAD_DATA;
+		return false;
+	}
+
+	fLastTime += delta;
+	event.time = fLastTime * 1000;
+
+	if (type < kPuzzleEvent) {
+		event.type = kPressEvent;
+		event.button = type;
+		return true;
+	}
+
+	event.type = (session_event_type) type;
+
+	uint64 values[4] = {};
+	bool isValid = true;
+
+	switch (type) {
+		case kPuzzleEvent:
+		{
+			// the board has to fit in a uint64
+			uint64 length;
+			isValid = _ReadVarint(values[0]) && values[0] > 0
+				&& values[0] <= 8 && _ReadVarint(length)
+				&& length <= fSize - fPosition;
+			if (!isValid)
+				break;
+
+			event.dimension = values[0];
+			event.pack = (const char*) fData + fPosition;
+			event.packLength = length;
+			fPosition += length;
+
+			isValid = _ReadVarint(values[1]) && values[1] <= INT32_MAX
+				&& _ReadVarint(values[2]) && values[2] <= UINT32_MAX
+				&& _ReadVarint(values[3]);
+
+			event.level = values[1];
+			event.seed = values[2];
+			event.board = values[3];
+			break;
+		}
+
+		case kFinishEvent:
+			isValid = _ReadVarint(values[0]) && values[0] <= INT32_MAX
+				&& _ReadVarint(values[1]) && values[1] <= kTooManyMovesOutcome;
+
+			event.moves = values[0];
+			event.outcome = (session_outcome) values[1];
+			break;
+
+		case kUndoEvent:
+		case kRedoEvent:
+		case kRestartEvent:
+		case kRestoreEvent:
+		case kNextBranchEvent:
+		case kPreviousBranchEvent:
+			break;
+
+		default:
+			isValid = false;
+			break;
+	}
+
+	if (!isValid) {
+		fStatus = B_BAD_DATA;
+		return false;
+	}
+
+	return true;
+}
+
+bool SessionReader::_ReadVarint(uint64& value)
+{
+	value = 0;
+
+	for (int32 shift = 0; shift < 64 && fPosition < fSize; shift += 7) {
+		const uint8 byte = fData[fPosition++];
+		value |= (uint64) (byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,130 @@
+#ifndef SESSION_LOG_H
+#define SESSION_LOG_H
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "CoreDefs.h"
+
+// A session log records everything that happens to the board while the game
+// is played: the puzzle put up for each level, every button pressed, every
+// undo, redo and jump through the move history, and how each puzzle ended.
+// SessionReplayer plays it back without the user interface.
+//
+// The log starts with an 8 byte magic and a version byte. Each event after
+// that is a type byte, the milliseconds since the previous event as a
+// varint (7 bits per byte, low bits first, the high bit set on all but the
+// last byte) and the fields of its type, also as varints. A press has its
+// button as the type byte and no fields, so most events take two or three
+// bytes.
+
+enum session_event_type {
+	kPressEvent = 0,			// type bytes 0 to 63 are presses
+	kPuzzleEvent = 64,			// dimension, pack, level, seed, board
+	kUndoEvent,
+	kRedoEvent,
+	kRestartEvent,
+	kRestoreEvent,
+	kNextBranchEvent,
+	kPreviousBranchEvent,
+	kFinishEvent				// moves, outcome
+};
+
+enum session_outcome {
+	kSolvedOutcome = 0,
+	kTooManyMovesOutcome
+};
+
+struct session_event {
+	session_event_type	type;
+	int64				time;		// in microseconds, to the millisecond
+	int8				button;
+
+	// kPuzzleEvent; the pack name is not terminated and points into the log,
+	// and is empty for random puzzles
+	int8				dimension;
+	const char*			pack;
+	int32				packLength;
+	int32				level;
+	uint32				seed;
+	uint64				board;
+
+	// kFinishEvent
+	int32				moves;
+	session_outcome		outcome;
+};
+
+
+session_outcome FinishOutcome(int32 movesRequired, int32 moves);
+
+// logs named after the time they were started, in microseconds
+status_t PruneSessionLogs(const char* directory, int32 keep);
+
+
+// The SessionRecorder class writes a session log. Events collect in memory
+// until Flush(), which appends them to the file given to Open(); without a
+// file they are dropped there, so only Data() ever sees them. Every file
+// starts with the header, even one opened after an earlier one was closed.
+
+class SessionRecorder
+{
+public:
+	SessionRecorder();
+	~SessionRecorder();
+
+	status_t Open(const char* path);
+	void Close();
+	status_t Flush();
+
+	void Reset();
+
+	void StartPuzzle(int64 time, int8 dimension, const char* pack, int32 level,
+		uint32 seed, uint64 board);
+	void AddPress(int64 time, int8 button);
+	void AddEvent(int64 time, session_event_type type);
+	void Finish(int64 time, int32 moves, session_outcome outcome);
+
+	const uint8* Data() const { return fData.data(); }
+	size_t Size() const { return fData.size(); }
+
+private:
+	SessionRecorder(const SessionRecorder&);
+	SessionRecorder& operator=(const SessionRecorder&);
+
+	void _AddHeader(int64 time, uint8 type);
+	void _AddVarint(uint64 value);
+
+	FILE* fFile;
+	std::vector<uint8> fData;
+	size_t fHeaderSize;	// of the header at the start of fData, if any
+	int64 fLastTime;	// in milliseconds
+};
+
+
+// The SessionReader class takes a session log apart into its events. Next()
+// returns false at the end of the log, and also on a malformed event, after
+// which InitCheck() is B_BAD_DATA.
+
+class SessionReader
+{
+public:
+	enum { kVersion = 1 };
+
+	SessionReader(const uint8* data, size_t size);
+
+	status_t InitCheck() const { return fStatus; }
+	bool Next(session_event& event);
+	size_t Offset() const { return fPosition; }
+
+private:
+	bool _ReadVarint(uint64& value);
+
+	const uint8* fData;
+	size_t fSize;
+	size_t fPosition;
+	int64 fLastTime;
+	status_t fStatus;
+};
+
+#endif
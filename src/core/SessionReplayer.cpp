@@ -0,0 +1,164 @@
+#include "SessionReplayer.h"
+
+#include <string.h>
+
+#include "PuzzlePack.h"
+#include "SessionLog.h"
+
+
+SessionReplayer::SessionReplayer(PuzzlePackSet& packs)
+	:
+	fPacks(packs),
+	fPack(NULL),
+	fLevel(0),
+	fMovesRequired(-1),
+	fHasPuzzle(false),
+	fIsFinished(false),
+	fGrid(1),
+	fErrorOffset(0),
+	fNumPuzzles(0),
+	fNumSolved(0),
+	fNumEvents(0)
+{
+}
+
+/*
+ * Play back the log in data. Returns B_BAD_DATA if it is malformed and
+ * B_ERROR if it doesn't come out as recorded; either way ErrorOffset() is
+ * where the event in question ends.
+ */
+
+status_t SessionReplayer::Replay(const uint8* data, size_t size)
+{
+	fPack = NULL;
+	fHasPuzzle = fIsFinished = false;
+	fErrorOffset = 0;
+	fNumPuzzles = fNumSolved = fNumEvents = 0;
+
+	SessionReader reader(data, size);
+	if (reader.InitCheck() != B_OK)
+		return reader.InitCheck();
+
+	session_event event;
+	while (reader.Next(event)) {
+		fNumEvents++;
+
+		if (!_Apply(event)) {
+			fErrorOffset = reader.Offset();
+			return B_ERROR;
+		}
+	}
+
+	if (reader.InitCheck() != B_OK) {
+		fErrorOffset = reader.Offset();
+		return reader.InitCheck();
+	}
+
+	return B_OK;
+}
+
+bool SessionReplayer::_StartPuzzle(const session_event& event)
+{
+	fPack = NULL;
+	fLevel = event.level;
+	fMovesRequired = -1;
+	fHasPuzzle = false;
+	fGrid.SetRules(Rules());
+	fGrid.SetDimension(event.dimension);
+
+	if (event.packLength > 0) {
+		for (int32 index = 0; index < fPacks.CountPacks(); index++) {
+			PuzzlePack* pack = fPacks.PackAt(index);
+			if (strlen(pack->Name()) == (size_t) event.packLength
+				&& memcmp(pack->Name(), event.pack, event.packLength) == 0) {
+				fPack = pack;
+				break;
+			}
+		}
+
+		// packs found by PackCatalogue are only mapped once they're played
+		if (fPack == NULL || fPack->Load() != B_OK
+			|| fPack->Dimension() != event.dimension
+			|| (uint32) fLevel >= fPack->Size()
+			|| fPack->ValueAt(fLevel) != event.board)
+			return false;
+
+		fGrid.SetRules(fPack->GetRules());
+		fGrid.SetGridValues(event.board);
+		fMovesRequired = fPack->MovesRequired(fLevel);
+	} else {
+		// the same moves GridView::SetLevel() made up
+		RandomGenerator generator(event.seed);
+		fGrid.Random(fLevel + 1, generator);
+
+		if (fGrid.GetGridValues() != event.board)
+			return false;
+	}
+
+	fHistory.Start(fGrid);
+	fHasPuzzle = true;
+	fNumPuzzles++;
+	return true;
+}
+
+bool SessionReplayer::_Apply(const session_event& event)
+{
+	// a press that solves the puzzle is followed by how it ended
+	if (fIsFinished != (event.type == kFinishEvent))
+		return false;
+
+	if (event.type == kPuzzleEvent)
+		return _StartPuzzle(event);
+
+	if (!fHasPuzzle)
+		return false;
+
+	switch (event.type) {
+		case kPressEvent:
+		{
+			const int8 dimension = fGrid.Dimension();
+			if (event.button >= dimension * dimension)
+				return false;
+
+			if (!fHistory.PressOrUndo(event.button) && fHistory.Board() == 0)
+				fIsFinished = true;
+			break;
+		}
+
+		case kUndoEvent:
+			fHistory.Undo();
+			break;
+		case kRedoEvent:
+			fHistory.Redo();
+			break;
+		case kRestartEvent:
+			fHistory.Seek(fHistory.First());
+			break;
+		case kRestoreEvent:
+			fHistory.Seek(fHistory.Length());
+			break;
+		case kNextBranchEvent:
+			fHistory.NextBranch();
+			break;
+		case kPreviousBranchEvent:
+			fHistory.PreviousBranch();
+			break;
+
+		case kFinishEvent:
+		{
+			const int32 moves = fHistory.Position();
+			if (event.moves != moves
+				|| event.outcome != FinishOutcome(fMovesRequired, moves))
+				return false;
+
+			fIsFinished = false;
+			fNumSolved++;
+			break;
+		}
+
+		default:
+			return false;
+	}
+
+	return true;
+}
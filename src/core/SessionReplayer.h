@@ -0,0 +1,53 @@
+#ifndef SESSION_REPLAYER_H
+#define SESSION_REPLAYER_H
+
+#include "CoreDefs.h"
+#include "Grid.h"
+#include "MoveHistory.h"
+
+class PuzzlePack;
+class PuzzlePackSet;
+struct session_event;
+
+// The SessionReplayer class plays a session log back on a Grid and a
+// MoveHistory, the way GridView played it, and checks that it comes out the
+// same: each puzzle has to be the one its pack and level, or for random
+// puzzles its seed, stand for, and every puzzle solved has to end with the
+// move count and outcome the log reports, and no others.
+//
+// Nothing is allocated per log, so one replayer can go through thousands of
+// logs a second.
+
+class SessionReplayer
+{
+public:
+	SessionReplayer(PuzzlePackSet& packs);
+
+	status_t Replay(const uint8* data, size_t size);
+
+	size_t ErrorOffset() const { return fErrorOffset; }
+
+	int32 CountPuzzles() const { return fNumPuzzles; }
+	int32 CountSolved() const { return fNumSolved; }
+	int32 CountEvents() const { return fNumEvents; }
+
+private:
+	bool _StartPuzzle(const session_event& event);
+	bool _Apply(const session_event& event);
+
+	PuzzlePackSet& fPacks;
+	PuzzlePack* fPack;
+	int32 fLevel;
+	int32 fMovesRequired;
+	bool fHasPuzzle;
+	bool fIsFinished;
+	Grid fGrid;
+	MoveHistory fHistory;
+
+	size_t fErrorOffset;
+	int32 fNumPuzzles;
+	int32 fNumSolved;
+	int32 fNumEvents;
+};
+
+#endif
@@ -0,0 +1,523 @@
+#include "Solver.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <mutex>
+
+#include "Board.h"
+
+int32 CountBits(uint64 value)
+{
+	return __builtin_popcountll(value);
+}
+
+int32 CountBits(const uint64* words, int32 numWords)
+{
+	int32 count = 0;
+
+	for (int32 index = 0; index < numWords; index++)
+		count += __builtin_popcountll(words[index]);
+
+	return count;
+}
+
+static inline bool
+TestBit(const uint64* words, int32 bit)
+{
+	return (words[bit / 64] >> (bit % 64)) & 1;
+}
+
+static inline void
+FlipBit(uint64* words, int32 bit)
+{
+	words[bit / 64] ^= (uint64) 1 << (bit % 64);
+}
+
+static inline void
+XorWords(uint64* dest, const uint64* src, int32 numWords)
+{
+	for (int32 index = 0; index < numWords; index++)
+		dest[index] ^= src[index];
+}
+
+static inline bool
+Parity(const uint64* row, const uint64* words, int32 numWords)
+{
+	uint64 sum = 0;
+
+	for (int32 index = 0; index < numWords; index++)
+		sum ^= row[index] & words[index];
+
+	return __builtin_parityll(sum);
+}
+
+
+static const int32 maxExhaustiveNullity = 20;
+
+// above this nullity, a coset table is built if there are at most
+// 2^maxTableRank cosets
+static const int32 maxWalkNullity = 10;
+static const int32 maxTableRank = 20;
+
+// the most words a press set takes, for a 127x127 grid
+static const int32 maxWords = (127 * 127 + 63) / 64;
+
+// built on first use and kept for the lifetime of the process
+static Solver* sSolvers[128];
+static Solver* sRuleSolvers[kNumNeighbourhoods][2][9];
+static std::mutex sSolversLock;
+
+
+/*
+ * The Solver for dimension under rules. Grids with rules other than the
+ * classic ones go up to 8x8. As with ChaseSolver::ForDimension(), any
+ * thread may ask, and one that asks while it is being built waits for it.
+ */
+
+const Solver& Solver::ForDimension(int8 dimension, const Rules& rules)
+{
+	assert(dimension > 0);
+
+	std::lock_guard<std::mutex> lock(sSolversLock);
+
+	Solver** solver = &sSolvers[dimension];
+	if (!rules.IsClassic()) {
+		assert(dimension <= 8);
+		solver = &sRuleSolvers[rules.Shape()][rules.IsToroidal()][dimension];
+	}
+
+	if (*solver == NULL)
+		*solver = new Solver(dimension, rules);
+
+	return **solver;
+}
+
+Solver::Solver(int8 dimension, const Rules& rules)
+	:
+	fDimension(dimension),
+	fRules(rules),
+	fNumWords((dimension * dimension + 63) / 64)
+{
+	assert(rules.IsClassic() || dimension <= 8);
+
+	_Eliminate();
+}
+
+/*
+ * Row offset of the press matrix: the lights toggled by pressing the button
+ * at offset. The matrix is symmetric, so this is also column offset.
+ */
+
+void Solver::PressRow(int8 dimension, int32 offset, uint64* row)
+{
+	const int32 n = dimension;
+
+	memset(row, 0, (n * n + 63) / 64 * sizeof(uint64));
+	FlipBit(row, offset);
+
+	if (offset % n)	// not leftmost column
+		FlipBit(row, offset - 1);
+
+	if ((offset + 1) % n)	// not rightmost column
+		FlipBit(row, offset + 1);
+
+	if (offset >= n)	// not top row
+		FlipBit(row, offset - n);
+
+	if (offset < n * (n - 1))	// not bottom row
+		FlipBit(row, offset + n);
+}
+
+/*
+ * Bring [A | I] to reduced row echelon form [R | E] and keep what solving
+ * needs: E row r is the inverse row of the press in pivot column r, the rows
+ * of E below the rank are the checks, and every free column of R yields one
+ * null space vector.
+ */
+
+void Solver::_Eliminate()
+{
+	const int32 numCells = fDimension * fDimension;
+	const int32 w = fNumWords;
+
+	std::vector<uint64> rows(numCells * w);
+	std::vector<uint64> transform(numCells * w, 0);
+	std::vector<int32> pivots;
+
+	for (int32 index = 0; index < numCells; index++) {
+		if (fRules.IsClassic())
+			PressRow(fDimension, index, &rows[index * w]);
+		else
+			rows[index] = fRules.PressMask(fDimension, index);
+
+		FlipBit(&transform[index * w], index);
+	}
+
+	int32 rank = 0;
+
+	for (int32 column = 0; column < numCells; column++) {
+		int32 pivot = rank;
+		while (pivot < numCells && !TestBit(&rows[pivot * w], column))
+			pivot++;
+
+		if (pivot == numCells)
+			continue;	// free column
+
+		if (pivot != rank) {
+			for (int32 index = 0; index < w; index++) {
+				uint64 tmp = rows[pivot * w + index];
+				rows[pivot * w + index] = rows[rank * w + index];
+				rows[rank * w + index] = tmp;
+
+				tmp = transform[pivot * w + index];
+				transform[pivot * w + index] = transform[rank * w + index];
+				transform[rank * w + index] = tmp;
+			}
+		}
+
+		for (int32 row = 0; row < numCells; row++) {
+			if (row == rank || !TestBit(&rows[row * w], column))
+				continue;
+
+			XorWords(&rows[row * w], &rows[rank * w], w);
+			XorWords(&transform[row * w], &transform[rank * w], w);
+		}
+
+		pivots.push_back(column);
+		rank++;
+	}
+
+	fRank = rank;
+
+	fInverse.assign(numCells * w, 0);
+	for (int32 row = 0; row < rank; row++)
+		memcpy(&fInverse[pivots[row] * w], &transform[row * w],
+			w * sizeof(uint64));
+
+	fChecks.assign(transform.begin() + rank * w, transform.end());
+
+	fNullBasis.clear();
+	int32 nullity = 0;
+
+	for (int32 column = 0, row = 0; column < numCells; column++) {
+		if (row < rank && pivots[row] == column) {
+			row++;
+			continue;
+		}
+
+		fNullBasis.resize((nullity + 1) * w, 0);
+		uint64* vector = &fNullBasis[nullity * w];
+		FlipBit(vector, column);
+
+		for (int32 pivotRow = 0; pivotRow < rank; pivotRow++)
+			if (TestBit(&rows[pivotRow * w], column))
+				FlipBit(vector, pivots[pivotRow]);
+
+		nullity++;
+	}
+
+	if (nullity > maxWalkNullity && rank <= maxTableRank && w == 1)
+		_BuildCosetTable(pivots);
+}
+
+/*
+ * Number the cosets of the null space by the pivot bits of their member with
+ * no free bits set, which every coset has exactly one of, and find the
+ * fewest presses of each by a breadth first search from the coset of the
+ * empty press set. Numbering is linear, so the coset of a press set is the
+ * XOR of the cosets of its presses.
+ */
+
+void Solver::_BuildCosetTable(const std::vector<int32>& pivots)
+{
+	const int32 numCells = fDimension * fDimension;
+	const uint32 numCosets = (uint32) 1 << fRank;
+
+	// where each pivot column goes in a coset number
+	int32 pivotIndices[64];
+	uint64 pivotMask = 0;
+
+	for (int32 row = 0; row < fRank; row++) {
+		pivotIndices[pivots[row]] = row;
+		pivotMask |= (uint64) 1 << pivots[row];
+	}
+
+	fPressCosets.assign(numCells, 0);
+
+	for (int32 row = 0; row < fRank; row++)
+		fPressCosets[pivots[row]] = (uint32) 1 << row;
+
+	// a free press is in the coset of the pivot bits of its null vector
+	for (int32 index = 0; index < Nullity(); index++) {
+		const uint64 vector = fNullBasis[index];
+		uint32 coset = 0;
+
+		for (uint64 bits = vector & pivotMask; bits != 0; bits &= bits - 1)
+			coset ^= (uint32) 1 << pivotIndices[__builtin_ctzll(bits)];
+
+		fPressCosets[__builtin_ctzll(vector & ~pivotMask)] = coset;
+	}
+
+	fCosetMoves.assign(numCosets, 0xff);
+	fCosetMoves[0] = 0;
+
+	std::vector<uint32> queue(numCosets);
+	uint32 head = 0;
+	uint32 tail = 0;
+	queue[tail++] = 0;
+
+	while (head < tail) {
+		const uint32 coset = queue[head++];
+		const uint8 moves = fCosetMoves[coset] + 1;
+
+		for (int32 press = 0; press < numCells; press++) {
+			const uint32 next = coset ^ fPressCosets[press];
+			if (fCosetMoves[next] == 0xff) {
+				fCosetMoves[next] = moves;
+				queue[tail++] = next;
+			}
+		}
+	}
+}
+
+/*
+ * Replace a solution by the lightest one in its coset, walking the null space
+ * in Gray code order with one XOR per step, or down the coset table if there
+ * is one. Past maxExhaustiveNullity that walk gets too long (64x64 has
+ * nullity 28), so the solution is only improved one null space vector at a
+ * time until none helps. That is fast but can leave it well above the
+ * optimum.
+ */
+
+void Solver::Minimize(uint64* presses) const
+{
+	const int32 w = fNumWords;
+	const int32 nullity = Nullity();
+
+	if (nullity == 0)
+		return;
+
+	if (w == 1
+		&& (!fCosetMoves.empty() || nullity <= maxExhaustiveNullity)) {
+		presses[0] = Minimize(presses[0]);
+		return;
+	}
+
+	uint64 current[maxWords];
+	memcpy(current, presses, w * sizeof(uint64));
+	int32 bestCount = CountBits(presses, w);
+
+	if (nullity > maxExhaustiveNullity) {
+		for (bool improved = true; improved;) {
+			improved = false;
+
+			for (int32 index = 0; index < nullity; index++) {
+				XorWords(current, NullVector(index), w);
+
+				const int32 count = CountBits(current, w);
+				if (count < bestCount) {
+					bestCount = count;
+					improved = true;
+				} else
+					XorWords(current, NullVector(index), w);
+			}
+		}
+
+		memcpy(presses, current, w * sizeof(uint64));
+		return;
+	}
+
+	for (uint32 step = 1; step < (uint32) 1 << nullity; step++) {
+		XorWords(current, NullVector(__builtin_ctz(step)), w);
+
+		const int32 count = CountBits(current, w);
+		if (count < bestCount) {
+			bestCount = count;
+			memcpy(presses, current, w * sizeof(uint64));
+		}
+	}
+}
+
+/*
+ * Minimize() for boards of one word, which is most of them, without going
+ * through arrays of words.
+ */
+
+uint64 Solver::Minimize(uint64 presses) const
+{
+	assert(fNumWords == 1);
+
+	const int32 nullity = Nullity();
+
+	if (!fCosetMoves.empty())
+		return _MinimizeByTable(presses);
+
+	if (nullity > maxExhaustiveNullity) {
+		Minimize(&presses);
+		return presses;
+	}
+
+	uint64 current = presses;
+	int32 bestCount = CountBits(presses);
+
+	for (uint32 step = 1; step < (uint32) 1 << nullity; step++) {
+		current ^= fNullBasis[__builtin_ctz(step)];
+
+		const int32 count = CountBits(current);
+		if (count < bestCount) {
+			bestCount = count;
+			presses = current;
+		}
+	}
+
+	return presses;
+}
+
+/*
+ * The lightest press set in the coset of presses, one press at a time: each
+ * step takes a press to a coset that needs one press less.
+ */
+
+uint64 Solver::_MinimizeByTable(uint64 presses) const
+{
+	uint32 coset = 0;
+
+	for (; presses != 0; presses &= presses - 1)
+		coset ^= fPressCosets[__builtin_ctzll(presses)];
+
+	uint64 lightest = 0;
+
+	for (int32 moves = fCosetMoves[coset]; moves > 0; moves--) {
+		int32 press = 0;
+		while (fCosetMoves[coset ^ fPressCosets[press]] != moves - 1)
+			press++;
+
+		coset ^= fPressCosets[press];
+		lightest |= (uint64) 1 << press;
+	}
+
+	return lightest;
+}
+
+bool Solver::Solve(uint64 lights, uint64& presses) const
+{
+	assert(fNumWords == 1);
+
+	if (!IsSolvable(lights))
+		return false;
+
+	const int32 numCells = fDimension * fDimension;
+	uint64 solution = 0;
+
+	for (int32 index = 0; index < numCells; index++)
+		solution |= (uint64) __builtin_parityll(fInverse[index] & lights)
+			<< index;
+
+	Minimize(&solution);
+	presses = solution;
+	return true;
+}
+
+/*
+ * Find the solution with the fewest presses. Returns false, leaving presses
+ * untouched, if the lights can't be turned off.
+ */
+
+bool Solver::Solve(const uint64* lights, uint64* presses) const
+{
+	if (!IsSolvable(lights))
+		return false;
+
+	const int32 numCells = fDimension * fDimension;
+	const int32 w = fNumWords;
+
+	memset(presses, 0, w * sizeof(uint64));
+	for (int32 index = 0; index < numCells; index++)
+		if (Parity(&fInverse[index * w], lights, w))
+			FlipBit(presses, index);
+
+	Minimize(presses);
+	return true;
+}
+
+bool Solver::Solve(const Board& lights, Board& presses) const
+{
+	assert(lights.Dimension() == fDimension);
+
+	std::vector<uint64> packedLights(fNumWords);
+	std::vector<uint64> packedPresses(fNumWords);
+
+	lights.Pack(&packedLights[0]);
+	if (!Solve(&packedLights[0], &packedPresses[0]))
+		return false;
+
+	presses.SetDimension(fDimension);
+	presses.Unpack(&packedPresses[0]);
+	return true;
+}
+
+bool Solver::IsSolvable(uint64 lights) const
+{
+	assert(fNumWords == 1);
+
+	for (size_t index = 0; index < fChecks.size(); index++)
+		if (__builtin_parityll(fChecks[index] & lights))
+			return false;
+
+	return true;
+}
+
+bool Solver::IsSolvable(const uint64* lights) const
+{
+	const int32 w = fNumWords;
+	const int32 numChecks = fChecks.size() / w;
+
+	for (int32 index = 0; index < numChecks; index++)
+		if (Parity(&fChecks[index * w], lights, w))
+			return false;
+
+	return true;
+}
+
+bool Solver::IsSolvable(const Board& lights) const
+{
+	std::vector<uint64> packedLights(fNumWords);
+
+	lights.Pack(&packedLights[0]);
+	return IsSolvable(&packedLights[0]);
+}
+
+int32 Solver::MinimumMoves(uint64 lights) const
+{
+	assert(fNumWords == 1);
+
+	uint64 presses;
+
+	if (!Solve(lights, presses))
+		return -1;
+
+	return CountBits(presses);
+}
+
+/*
+ * The number of presses in an optimal solution, or -1 if there is none.
+ */
+
+int32 Solver::MinimumMoves(const uint64* lights) const
+{
+	std::vector<uint64> presses(fNumWords);
+
+	if (!Solve(lights, &presses[0]))
+		return -1;
+
+	return CountBits(&presses[0], fNumWords);
+}
+
+int32 Solver::MinimumMoves(const Board& lights) const
+{
+	std::vector<uint64> packedLights(fNumWords);
+
+	lights.Pack(&packedLights[0]);
+	return MinimumMoves(&packedLights[0]);
+}
@@ -0,0 +1,99 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <vector>
+
+#include "CoreDefs.h"
+#include "Rules.h"
+
+class Board;
+
+// The Solver class finds the fewest presses that turn off every light on an
+// n by n grid. Pressing is linear over GF(2), so a board b is solved by any x
+// with A x = b, where row i of the press matrix A is the press mask of button
+// i: Grid::PressMask(n, i) under the classic rules, Rules::PressMask() under
+// the others, which only go up to 8x8.
+//
+// The press matrix only depends on the dimension and the rules, so the
+// constructor reduces [A | I] once and keeps the result: a pseudo-inverse P
+// with A (P b) = b for every solvable b, the rows of the transform that must
+// vanish on solvable boards, and a basis of the null space of A. Solving is
+// then one AND and a parity per press, and the optimal solution is the
+// lightest of the 2^nullity vectors obtained by adding null space
+// combinations to P b (for the few large sizes with a nullity above 20 it is
+// only a local optimum). ForDimension() hands out one lazily built Solver per
+// dimension and rules.
+//
+// Some rule variants have a large null space but few cosets: the 6x6 torus
+// with the Moore neighbourhood has nullity 20 and rank 16. Walking 2^20
+// vectors on every Minimize() would take milliseconds, so for those the
+// constructor instead works out the fewest presses of each of the 2^rank
+// cosets, breadth first from the empty one, and Minimize() walks down that
+// table one press at a time.
+//
+// Boards with up to 64 lights are passed as a uint64 in the same layout as
+// Grid::GetGridValues(). Larger boards are passed as a Board, or packed into
+// NumWords() words with light i in bit (i % 64) of word (i / 64).
+
+class Solver
+{
+public:
+	Solver(int8 dimension, const Rules& rules = Rules());
+
+	static const Solver& ForDimension(int8 dimension,
+		const Rules& rules = Rules());
+
+	int8 Dimension() const { return fDimension; }
+	const Rules& GetRules() const { return fRules; }
+	int32 NumWords() const { return fNumWords; }
+	int32 Rank() const { return fRank; }
+	int32 Nullity() const { return fDimension * fDimension - fRank; }
+	const uint64* NullVector(int32 index) const
+		{ return &fNullBasis[index * fNumWords]; }
+	const uint64* InverseRow(int32 press) const
+		{ return &fInverse[press * fNumWords]; }
+	int32 NumChecks() const { return fChecks.size() / fNumWords; }
+	const uint64* CheckRow(int32 index) const
+		{ return &fChecks[index * fNumWords]; }
+
+	bool Solve(uint64 lights, uint64& presses) const;
+	bool Solve(const uint64* lights, uint64* presses) const;
+	bool Solve(const Board& lights, Board& presses) const;
+	bool IsSolvable(uint64 lights) const;
+	bool IsSolvable(const uint64* lights) const;
+	bool IsSolvable(const Board& lights) const;
+	int32 MinimumMoves(uint64 lights) const;
+	int32 MinimumMoves(const uint64* lights) const;
+	int32 MinimumMoves(const Board& lights) const;
+
+	void Minimize(uint64* presses) const;
+	uint64 Minimize(uint64 presses) const;
+
+	static void PressRow(int8 dimension, int32 offset, uint64* row);
+
+private:
+	void _Eliminate();
+	void _BuildCosetTable(const std::vector<int32>& pivots);
+	uint64 _MinimizeByTable(uint64 presses) const;
+
+	int8 fDimension;
+	Rules fRules;
+	int32 fNumWords;
+	int32 fRank;
+
+	// one row per press, all zero for presses in free columns
+	std::vector<uint64> fInverse;
+	// one row per dependent equation of A
+	std::vector<uint64> fChecks;
+	std::vector<uint64> fNullBasis;
+
+	// the coset of each single press, as an index into fCosetMoves, and the
+	// fewest presses in each coset; empty unless the table is used
+	std::vector<uint32> fPressCosets;
+	std::vector<uint8> fCosetMoves;
+};
+
+int32 CountBits(uint64 value);
+int32 CountBits(const uint64* words, int32 numWords);
+
+#endif
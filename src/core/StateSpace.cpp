@@ -0,0 +1,90 @@
+#include "StateSpace.h"
+
+#include <assert.h>
+
+#include <thread>
+
+#include "ChaseSolver.h"
+
+static const int32 maxMoves = 16;	// what fits in a nibble
+
+
+StateSpace::StateSpace(int8 dimension, int32 numThreads)
+	:
+	fDimension(dimension)
+{
+	assert(dimension > 0 && dimension <= kMaxDimension);
+
+	const uint64 numBoards = (uint64) 1 << (dimension * dimension);
+	const uint64 numBlocks = BoardDistances::CountBlocks(dimension);
+
+	fData.resize((numBoards + 1) / 2);
+	fIndex.resize(maxMoves * (numBlocks + 1));
+
+	if (numThreads < 1)
+		numThreads = std::thread::hardware_concurrency();
+	if (numThreads < 1)
+		numThreads = 1;
+
+	std::vector<std::thread> workers;
+	const uint64 chunk = (numBlocks + numThreads - 1) / numThreads;
+
+	for (uint64 first = 0; first < numBlocks; first += chunk) {
+		const uint64 end = first + chunk < numBlocks
+			? first + chunk : numBlocks;
+
+		workers.push_back(std::thread(&StateSpace::_Enumerate, this, first,
+			end));
+	}
+
+	for (size_t index = 0; index < workers.size(); index++)
+		workers[index].join();
+
+	// turn the counts of each block into counts before it, and the total
+	int32 numLevels = 0;
+
+	for (int32 moves = 0; moves < maxMoves; moves++) {
+		uint32* counts = &fIndex[moves * (numBlocks + 1)];
+		uint32 before = 0;
+
+		for (uint64 block = 0; block <= numBlocks; block++) {
+			const uint32 count = counts[block];
+			counts[block] = before;
+			before += count;
+		}
+
+		if (before > 0)
+			numLevels = moves + 1;
+	}
+
+	fIndex.resize(numLevels * (numBlocks + 1));
+	fDistances.SetTo(dimension, &fData[0], &fIndex[0], numLevels);
+}
+
+/*
+ * Fill in the boards of the blocks [firstBlock, endBlock), and count them
+ * into the index by move count. Blocks are a whole number of bytes, and the
+ * threads work on disjoint ones, so they never share a nibble.
+ */
+
+void StateSpace::_Enumerate(uint64 firstBlock, uint64 endBlock)
+{
+	const ChaseSolver& solver = ChaseSolver::ForDimension(fDimension);
+	const uint64 numBoards = (uint64) 1 << (fDimension * fDimension);
+	const uint64 numBlocks = BoardDistances::CountBlocks(fDimension);
+	const uint64 blockSize = BoardDistances::kBlockSize;
+
+	uint64 end = endBlock * blockSize;
+	if (end > numBoards)
+		end = numBoards;
+
+	for (uint64 board = firstBlock * blockSize; board < end; board++) {
+		const int32 moves = solver.MinimumMoves(board);
+		if (moves < 0)
+			continue;
+
+		assert(moves < maxMoves);
+		fData[board / 2] |= moves << ((board & 1) * 4);
+		fIndex[moves * (numBlocks + 1) + board / blockSize]++;
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef STATE_SPACE_H
+#define STATE_SPACE_H
+
+#include <vector>
+
+#include "BoardDistances.h"
+#include "CoreDefs.h"
+#include "Random.h"
+
+// The StateSpace class holds the optimal move count of every board of a
+// dimension up to 5x5, worked out on several threads when it is built, in
+// the distance table and level index BoardDistances reads. The table takes
+// 16 MB for 5x5 and the index 512 KB. Both are complete once the constructor
+// returns, so any number of threads can draw boards from them.
+//
+// Larger grids don't need a table: 6x6 through 8x8 have a nullity of 0, so a
+// board's only solution is optimal and Solver finds it directly, and the
+// number of boards needing k moves is simply C(n * n, k).
+
+class StateSpace
+{
+public:
+	enum { kMaxDimension = 5 };
+
+	StateSpace(int8 dimension, int32 numThreads = 0);
+
+	int8 Dimension() const { return fDimension; }
+
+	int32 MinimumMoves(uint64 board) const
+		{ return fDistances.MinimumMoves(board); }
+	int32 MaxMoves() const { return fDistances.MaxMoves(); }
+	uint64 CountBoards(int32 moves) const
+		{ return fDistances.CountBoards(moves); }
+
+	uint64 RandomBoard(int32 moves,
+		RandomGenerator& generator = RandomGenerator::ForThread()) const
+		{ return fDistances.RandomBoard(moves, generator); }
+
+	const BoardDistances& Distances() const { return fDistances; }
+
+	const uint8* Data() const { return &fData[0]; }
+	size_t DataSize() const { return fData.size(); }
+	const uint32* Index() const { return &fIndex[0]; }
+	size_t IndexSize() const { return fIndex.size() * sizeof(uint32); }
+
+private:
+	void _Enumerate(uint64 firstBlock, uint64 endBlock);
+
+	int8 fDimension;
+	std::vector<uint8> fData;
+	std::vector<uint32> fIndex;
+	BoardDistances fDistances;
+};
+
+#endif
@@ -0,0 +1,224 @@
+/*
+ * Generates unique puzzles of a given size whose optimal solution takes
+ * exactly the given number of moves, on as many threads as there are cores.
+ *
+ * Usage: BatchGenerator -d dimension -m moves -n count [-t threads]
+ *		[-f csv|binary] [-o file] [-s seed]
+ *
+ * The csv format has one "board,moves" line per puzzle, with the board in
+ * hex in the layout of Grid::GetGridValues(). The binary format stores each
+ * board in the (dimension * dimension + 7) / 8 bytes it needs, least
+ * significant byte first.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "ChaseSolver.h"
+#include "Grid.h"
+#include "Random.h"
+
+// give up once this many boards in a row were rejected or already known
+static const uint64 maxFailures = 100000000;
+
+
+// A hash set split into shards with a lock each, so that threads inserting
+// different boards rarely wait for each other.
+
+class BoardSet
+{
+public:
+	bool Insert(uint64 board)
+	{
+		Shard& shard = fShards[Grid::HashBoard(board) % kNumShards];
+		std::lock_guard<std::mutex> lock(shard.lock);
+		return shard.boards.insert(board).second;
+	}
+
+private:
+	enum { kNumShards = 64 };
+
+	struct Shard {
+		std::mutex lock;
+		std::unordered_set<uint64> boards;
+	};
+
+	Shard fShards[kNumShards];
+};
+
+
+struct generator_job {
+	int8				dimension;
+	int8				moves;
+	uint64				count;
+	bool				binary;
+	FILE*				output;
+
+	BoardSet			boards;
+	std::atomic<uint64>	written;
+	std::atomic<uint64>	failures;
+	std::mutex			outputLock;
+};
+
+
+static void
+WriteBoard(generator_job& job, uint64 board)
+{
+	std::lock_guard<std::mutex> lock(job.outputLock);
+
+	if (job.binary) {
+		const int32 numBytes = (job.dimension * job.dimension + 7) / 8;
+		uint8 bytes[8];
+
+		for (int32 index = 0; index < numBytes; index++)
+			bytes[index] = board >> (index * 8);
+
+		fwrite(bytes, 1, numBytes, job.output);
+	} else
+		fprintf(job.output, "%llx,%d\n", (unsigned long long) board, job.moves);
+}
+
+
+/*
+ * Press a random set of exactly moves buttons and keep the board if it can't
+ * be solved in fewer and hasn't been generated before.
+ */
+
+static void
+Generate(generator_job& job, uint64 seed, int32 stream)
+{
+	const ChaseSolver& solver = ChaseSolver::ForDimension(job.dimension);
+	const int32 numButtons = job.dimension * job.dimension;
+
+	RandomGenerator generator(seed, stream);
+	int32 buttons[64];
+
+	for (int32 index = 0; index < numButtons; index++)
+		buttons[index] = index;
+
+	while (job.written < job.count && job.failures < maxFailures) {
+		Grid grid(job.dimension);
+
+		for (int32 index = 0; index < job.moves; index++) {
+			const int32 other = index + generator.Uniform(numButtons - index);
+			const int32 button = buttons[other];
+
+			buttons[other] = buttons[index];
+			buttons[index] = button;
+			grid.Press(button);
+		}
+
+		const uint64 board = grid.GetGridValues();
+
+		if (solver.MinimumMoves(board) != job.moves
+			|| !job.boards.Insert(board)) {
+			job.failures++;
+			continue;
+		}
+
+		if (job.written++ >= job.count)
+			break;
+
+		job.failures = 0;
+		WriteBoard(job, board);
+	}
+}
+
+
+static void
+Usage()
+{
+	fprintf(stderr, "usage: BatchGenerator -d dimension -m moves -n count "
+		"[-t threads] [-f csv|binary] [-o file] [-s seed]\n");
+	exit(2);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	generator_job job;
+	job.dimension = 0;
+	job.moves = 0;
+	job.count = 0;
+	job.binary = false;
+	job.output = stdout;
+	job.written = 0;
+	job.failures = 0;
+
+	int32 numThreads = std::thread::hardware_concurrency();
+	uint64 seed = std::random_device()();
+
+	int option;
+	while ((option = getopt(argc, argv, "d:m:n:t:f:o:s:")) != -1) {
+		switch (option) {
+			case 'd':
+				job.dimension = atoi(optarg);
+				break;
+			case 'm':
+				job.moves = atoi(optarg);
+				break;
+			case 'n':
+				job.count = strtoull(optarg, NULL, 10);
+				break;
+			case 't':
+				numThreads = atoi(optarg);
+				break;
+			case 'f':
+				if (strcmp(optarg, "binary") == 0)
+					job.binary = true;
+				else if (strcmp(optarg, "csv") != 0)
+					Usage();
+				break;
+			case 'o':
+				job.output = fopen(optarg, job.binary ? "wb" : "w");
+				if (job.output == NULL) {
+					perror(optarg);
+					return 1;
+				}
+				break;
+			case 's':
+				seed = strtoull(optarg, NULL, 10);
+				break;
+			default:
+				Usage();
+		}
+	}
+
+	if (job.dimension < 1 || job.dimension > 8 || job.moves < 1
+		|| job.moves > job.dimension * job.dimension || job.count == 0)
+		Usage();
+
+	if (numThreads < 1)
+		numThreads = 1;
+
+	std::vector<std::thread> workers;
+	for (int32 index = 0; index < numThreads; index++)
+		workers.push_back(std::thread(Generate, std::ref(job), seed, index));
+
+	for (int32 index = 0; index < numThreads; index++)
+		workers[index].join();
+
+	if (job.output != stdout)
+		fclose(job.output);
+	else
+		fflush(stdout);
+
+	const uint64 written = job.written;
+	if (written < job.count) {
+		fprintf(stderr, "only found %llu puzzles\n",
+			(unsigned long long) written);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,787 @@
+/*
+ * Micro-benchmarks for the hot paths of the core library: pressing and
+ * flipping lights, converting boards to and from uint64, generating random
+ * puzzles, recording and replaying moves, drawing random numbers, reading
+ * puzzle packs, solving and giving hints, plus the board kernels of every
+ * instruction set the CPU supports, the press kernels of every rule variant
+ * and boards with more than two states. Before timing the kernels, their
+ * results are checked against pressing the same buttons one at a time, the
+ * rule kernels against a plain walk over the neighbours of each button, the
+ * hint engine against Solver, and the multi-state solver by applying its
+ * solutions; any difference is reported and makes the exit status 1.
+ *
+ * Usage: CoreBenchmark [-csv] [-t milliseconds] [name prefix]
+ *	-csv	print name,iterations,ns/op,allocs/op lines instead of a table
+ *	-t	minimum time spent on each benchmark (default 20)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+
+#include "Board.h"
+#include "BoardKernels.h"
+#include "ChaseSolver.h"
+#include "Grid.h"
+#include "HintEngine.h"
+#include "ModularBoard.h"
+#include "ModularSolver.h"
+#include "MoveHistory.h"
+#include "PuzzleGenerator.h"
+#include "PuzzlePack.h"
+#include "Random.h"
+#include "Rules.h"
+#include "Solver.h"
+
+// levels offered by the Random menu for dimensions 3x3 through 8x8
+static const int8 minDimension = 3;
+static const int8 maxDimension = 8;
+static const int8 maxLevels[] = { 8, 7, 15, 35, 48, 63 };
+
+// number of light states for the multi-state benchmarks; 3 is the classic
+// three colour variant
+static const int8 modularStates[] = { 3, 4, 16 };
+static const int32 numModularStates
+	= sizeof(modularStates) / sizeof(modularStates[0]);
+
+static std::atomic<uint64> sAllocations(0);
+
+static bool sCSV = false;
+static double sMinTime = 20e6;	// in nanoseconds
+static const char* sPrefix = "";
+
+
+void*
+operator new(size_t size)
+{
+	sAllocations++;
+
+	void* pointer = malloc(size);
+	if (pointer == NULL)
+		throw std::bad_alloc();
+
+	return pointer;
+}
+
+
+void
+operator delete(void* pointer) noexcept
+{
+	free(pointer);
+}
+
+
+void
+operator delete(void* pointer, size_t) noexcept
+{
+	free(pointer);
+}
+
+
+// keep the compiler from optimizing away a result
+template<typename Type>
+static inline void
+Use(const Type& value)
+{
+	asm volatile("" : : "g"(value) : "memory");
+}
+
+
+/*
+ * Run body with growing iteration counts until a run takes at least the
+ * minimum time, then report the time and allocations per iteration of it.
+ */
+
+template<typename Body>
+static void
+Benchmark(const std::string& name, Body body)
+{
+	if (strncmp(name.c_str(), sPrefix, strlen(sPrefix)) != 0)
+		return;
+
+	uint64 iterations = 1;
+	double elapsed;
+	uint64 allocations;
+
+	for (;;) {
+		const uint64 allocationsBefore = sAllocations;
+		const std::chrono::steady_clock::time_point start
+			= std::chrono::steady_clock::now();
+
+		for (uint64 iteration = 0; iteration < iterations; iteration++)
+			body();
+
+		elapsed = std::chrono::duration<double, std::nano>(
+			std::chrono::steady_clock::now() - start).count();
+		allocations = sAllocations - allocationsBefore;
+
+		if (elapsed >= sMinTime || iterations >= (uint64) 1 << 40)
+			break;
+
+		iterations *= elapsed > 0 && sMinTime / elapsed < 100
+			? (uint64) (sMinTime / elapsed) + 1 : 100;
+	}
+
+	if (sCSV)
+		printf("%s,%llu,%.3f,%.3f\n", name.c_str(),
+			(unsigned long long) iterations, elapsed / iterations,
+			(double) allocations / iterations);
+	else
+		printf("%-32s %12llu %12.2f %10.2f\n", name.c_str(),
+			(unsigned long long) iterations, elapsed / iterations,
+			(double) allocations / iterations);
+}
+
+
+static std::string
+Name(const char* base, int dimension, int level = 0)
+{
+	char name[64];
+
+	if (level > 0)
+		snprintf(name, sizeof(name), "%s/%dx%d/%d", base, dimension,
+			dimension, level);
+	else
+		snprintf(name, sizeof(name), "%s/%dx%d", base, dimension, dimension);
+
+	return name;
+}
+
+
+static void
+GridBenchmarks()
+{
+	for (int8 n = minDimension; n <= maxDimension; n++) {
+		Grid grid(n);
+		const int8 numButtons = n * n;
+		int8 offset = 0;
+
+		Benchmark(Name("Grid::Press", n), [&]() {
+			Use(grid.Press(offset));
+			if (++offset == numButtons)
+				offset = 0;
+		});
+
+		Benchmark(Name("Grid::FlipValueAt", n), [&]() {
+			grid.FlipValueAt(offset);
+			Use(grid);
+			if (++offset == numButtons)
+				offset = 0;
+		});
+
+		uint64 value = 0x0123456789abcdefULL;
+
+		Benchmark(Name("Grid::SetGridValues", n), [&]() {
+			grid.SetGridValues(value);
+			Use(grid);
+			value = value * 6364136223846793005ULL + 1;
+		});
+
+		Benchmark(Name("Grid::GetGridValues", n), [&]() {
+			Use(grid.GetGridValues());
+		});
+	}
+
+	for (int32 shape = 0; shape < kNumNeighbourhoods; shape++) {
+		for (int32 toroidal = 0; toroidal < 2; toroidal++) {
+			const Rules rules((neighbourhood) shape, toroidal);
+			if (rules.IsClassic())
+				continue;
+
+			for (int8 n = minDimension; n <= maxDimension; n++) {
+				Grid grid(n);
+				grid.SetRules(rules);
+				const int8 numButtons = n * n;
+				int8 offset = 0;
+
+				Benchmark(Name("Grid::Press", n) + "/" + rules.Name(), [&]() {
+					Use(grid.Press(offset));
+					if (++offset == numButtons)
+						offset = 0;
+				});
+			}
+		}
+	}
+
+	for (int8 n = minDimension; n <= maxDimension; n++) {
+		Grid grid(n);
+
+		for (int8 level = 1; level <= maxLevels[n - minDimension]; level++) {
+			// the first 5x5 puzzle of a level enumerates its boards
+			grid.Random(level);
+
+			Benchmark(Name("Grid::Random", n, level), [&]() {
+				grid.Random(level);
+				Use(grid);
+			});
+		}
+	}
+}
+
+
+static void
+HistoryBenchmarks()
+{
+	for (int8 n = minDimension; n <= maxDimension; n++) {
+		Grid grid(n);
+		grid.Random(maxLevels[n - minDimension]);
+
+		MoveHistory history;
+		history.Start(grid);
+		const int8 numButtons = n * n;
+		int8 offset = 0;
+
+		// long enough to go through the pool and drop old moves again and
+		// again
+		Benchmark(Name("MoveHistory::Press", n), [&]() {
+			history.Press(offset);
+			offset = (offset + 7) % numButtons;
+		});
+
+		Benchmark(Name("MoveHistory::Undo+Redo", n), [&]() {
+			history.Undo();
+			history.Redo();
+			Use(history.Board());
+		});
+
+		int32 position = history.First();
+
+		Benchmark(Name("MoveHistory::Seek", n), [&]() {
+			history.Seek(position);
+			Use(history.Board());
+			position += 997;
+			if (position > history.Length())
+				position = history.First() + position % 13;
+		});
+	}
+}
+
+
+static void
+RandomBenchmarks()
+{
+	RandomGenerator generator(0);
+
+	// random() is what the generator replaced
+	Benchmark("random", [&]() {
+		Use(random());
+	});
+	Benchmark("RandomGenerator::Next", [&]() {
+		Use(generator.Next());
+	});
+	Benchmark("RandomGenerator::Uniform", [&]() {
+		Use(generator.Uniform(25));
+	});
+
+	for (int8 n = minDimension; n <= maxDimension; n++) {
+		const PuzzleGenerator& puzzles = PuzzleGenerator::ForDimension(n);
+
+		for (int8 k = 1; k <= maxLevels[n - minDimension]; k++) {
+			// the first 5x5 puzzle of a level enumerates its boards
+			puzzles.RandomPuzzle(k, generator);
+
+			Benchmark(Name("PuzzleGenerator::RandomPuzzle", n, k), [&]() {
+				Use(puzzles.RandomPuzzle(k, generator));
+			});
+		}
+	}
+}
+
+
+static void
+PackBenchmarks()
+{
+	PuzzlePackSet packs;
+
+	for (int32 index = 0; index < packs.CountPacks(); index++) {
+		PuzzlePack* pack = packs.PackAt(index);
+		uint32 level = 0;
+		std::string name = std::string("PuzzlePack::ValueAt/") + pack->Name();
+
+		Benchmark(name, [&]() {
+			Use(pack->ValueAt(level));
+			if (++level == pack->Size())
+				level = 0;
+		});
+	}
+}
+
+
+static void
+SolverBenchmarks()
+{
+	for (int8 n = minDimension; n <= maxDimension; n++) {
+		const Solver& solver = Solver::ForDimension(n);
+		const ChaseSolver& chaseSolver = ChaseSolver::ForDimension(n);
+		Grid grid(n);
+		grid.Random(maxLevels[n - minDimension]);
+		const uint64 board = grid.GetGridValues();
+
+		Benchmark(Name("Solver::Solve", n), [&]() {
+			uint64 presses;
+			Use(solver.Solve(board, presses));
+			Use(presses);
+		});
+
+		Benchmark(Name("ChaseSolver::Solve", n), [&]() {
+			uint64 presses;
+			Use(chaseSolver.Solve(board, presses));
+			Use(presses);
+		});
+
+		HintEngine hints;
+		hints.Start(grid);
+		int8 offset = 0;
+
+		// what a move costs while hints are shown
+		Benchmark(Name("HintEngine::Press+Hint", n), [&]() {
+			hints.Press(offset);
+			Use(hints.Hint());
+			offset = (offset + 7) % (n * n);
+		});
+
+		Benchmark(Name("HintEngine::FlipValueAt+Hint", n), [&]() {
+			hints.FlipValueAt(offset);
+			Use(hints.Hint());
+			offset = (offset + 7) % (n * n);
+		});
+	}
+
+	// the variant with the largest null space, 2^20 solutions per board
+	const Rules rules(kMooreNeighbourhood, true);
+	Grid grid(6);
+	grid.SetRules(rules);
+	grid.Random(20);
+
+	HintEngine hints;
+	hints.Start(grid);
+	int8 offset = 0;
+
+	Benchmark(Name("HintEngine::Press+Hint", 6) + "/" + rules.Name(), [&]() {
+		hints.Press(offset);
+		Use(hints.Hint());
+		offset = (offset + 7) % 36;
+	});
+}
+
+
+static RandomGenerator sRandom;
+
+
+static uint64
+RandomRow()
+{
+	return sRandom.Next();
+}
+
+
+/*
+ * Compare every kernel set with single presses on random boards of every
+ * size. Up to 8x8 the single presses are also checked against Grid.
+ */
+
+static bool
+CheckKernels()
+{
+	bool identical = true;
+
+	for (int8 n = 1; n <= Board::kMaxDimension; n++) {
+		for (int32 round = 0; round < 16; round++) {
+			Board presses(n);
+			Board expected(n);
+
+			for (int8 y = 0; y < n; y++) {
+				presses.SetRow(y, RandomRow());
+				expected.SetRow(y, RandomRow());
+			}
+
+			const Board start(expected);
+
+			for (int32 offset = 0; offset < n * n; offset++)
+				if (presses.ValueAt(offset))
+					expected.Press(offset);
+
+			if (n <= 8) {
+				Grid grid(n);
+				grid.SetGridValues(start.Values());
+
+				for (int32 offset = 0; offset < n * n; offset++)
+					if (presses.ValueAt(offset))
+						grid.Press(offset);
+
+				if (grid.GetGridValues() != expected.Values()) {
+					fprintf(stderr, "Board::Press differs from Grid::Press "
+						"on %dx%d\n", n, n);
+					identical = false;
+				}
+			}
+
+			for (int32 index = 0; index < CountBoardKernels(); index++) {
+				const board_kernels& kernels = BoardKernelsAt(index);
+				uint64 rows[Board::kMaxDimension];
+				uint64 pressRows[Board::kMaxDimension];
+
+				for (int8 y = 0; y < n; y++) {
+					rows[y] = start.Row(y);
+					pressRows[y] = presses.Row(y);
+				}
+
+				kernels.PressRows(rows, pressRows, n, presses.RowMask());
+
+				bool same = kernels.IsZero(rows, n) == expected.IsZero();
+				for (int8 y = 0; y < n; y++)
+					same = same && rows[y] == expected.Row(y);
+
+				kernels.XorRows(rows, rows, n);
+				same = same && kernels.IsZero(rows, n);
+
+				if (!same) {
+					fprintf(stderr, "%s kernels differ from single presses "
+						"on %dx%d\n", kernels.name, n, n);
+					identical = false;
+				}
+			}
+		}
+	}
+
+	return identical;
+}
+
+
+/*
+ * The lights toggled by a press, worked out one neighbour at a time.
+ */
+
+static uint64
+NeighbourMask(const Rules& rules, int8 n, int8 offset)
+{
+	uint64 mask = 0;
+
+	for (int32 dy = -1; dy <= 1; dy++) {
+		for (int32 dx = -1; dx <= 1; dx++) {
+			const int32 distance = abs(dx) + abs(dy);
+			if ((rules.Shape() == kPlusNeighbourhood && distance > 1)
+				|| (rules.Shape() == kXNeighbourhood && distance == 1))
+				continue;
+
+			int32 x = offset % n + dx;
+			int32 y = offset / n + dy;
+
+			if (rules.IsToroidal()) {
+				x = (x + n) % n;
+				y = (y + n) % n;
+			} else if (x < 0 || y < 0 || x >= n || y >= n)
+				continue;
+
+			mask |= (uint64) 1 << (x + y * n);
+		}
+	}
+
+	return mask;
+}
+
+
+/*
+ * Compare the press kernel of every rule with NeighbourMask(), both for
+ * single buttons and for random sets of them.
+ */
+
+static bool
+CheckRules()
+{
+	bool identical = true;
+
+	for (int32 shape = 0; shape < kNumNeighbourhoods; shape++) {
+		for (int32 toroidal = 0; toroidal < 2; toroidal++) {
+			const Rules rules((neighbourhood) shape, toroidal);
+
+			for (int8 n = toroidal ? 3 : 1; n <= 8; n++) {
+				const rule_geometry geometry(n);
+				bool same = true;
+
+				for (int32 round = 0; round < 16; round++) {
+					const uint64 presses = RandomRow() & geometry.fullMask;
+					uint64 expected = 0;
+
+					for (int8 offset = 0; offset < n * n; offset++) {
+						const uint64 mask = NeighbourMask(rules, n, offset);
+						same = same && rules.PressMask(n, offset) == mask;
+						if ((presses >> offset) & 1)
+							expected ^= mask;
+					}
+
+					same = same && rules.Spread(geometry, presses) == expected;
+				}
+
+				if (!same) {
+					fprintf(stderr, "%s rule kernel differs from its "
+						"neighbours on %dx%d\n", rules.Name(), n, n);
+					identical = false;
+				}
+			}
+		}
+	}
+
+	return identical;
+}
+
+
+/*
+ * The fewest presses in the coset of presses, by trying every combination
+ * of the null space.
+ */
+
+static int32
+LightestInCoset(const Solver& solver, uint64 presses)
+{
+	int32 lightest = CountBits(presses);
+
+	for (uint32 step = 1; step < (uint32) 1 << solver.Nullity(); step++) {
+		presses ^= *solver.NullVector(__builtin_ctz(step));
+		if (CountBits(presses) < lightest)
+			lightest = CountBits(presses);
+	}
+
+	return lightest;
+}
+
+
+/*
+ * Press buttons and flip lights at random under every rule variant and
+ * check that the hint always turns off what is left, that the board can be
+ * solved exactly when Solver says so, and that no other solution takes
+ * fewer presses.
+ */
+
+static bool
+CheckHints()
+{
+	bool identical = true;
+	HintEngine hints;
+
+	for (int32 shape = 0; shape < kNumNeighbourhoods; shape++) {
+		for (int32 toroidal = 0; toroidal < 2; toroidal++) {
+			const Rules rules((neighbourhood) shape, toroidal);
+
+			for (int8 n = toroidal ? 3 : 1; n <= 8; n++) {
+				const rule_geometry geometry(n);
+				const Solver& solver = Solver::ForDimension(n, rules);
+				Grid grid(n);
+				grid.SetRules(rules);
+				grid.SetGridValues(
+					rules.Spread(geometry, RandomRow() & geometry.fullMask));
+				hints.Start(grid);
+				bool same = true;
+
+				for (int32 round = 0; round < 64; round++) {
+					const int8 offset = sRandom.Uniform(n * n);
+					if (sRandom.Uniform(4) == 0) {
+						grid.FlipValueAt(offset);
+						hints.FlipValueAt(offset);
+					} else {
+						grid.Press(offset);
+						hints.Press(offset);
+					}
+
+					const uint64 board = grid.GetGridValues();
+					same = same && hints.IsSolvable()
+							== solver.IsSolvable(board)
+						&& (!hints.IsSolvable()
+							|| (rules.Spread(geometry, hints.Hint()) == board
+								&& hints.MovesRemaining() == LightestInCoset(
+									solver, hints.Hint())));
+
+					// with a small rank, one flip is enough to keep every
+					// later board unsolvable
+					if (!hints.IsSolvable()) {
+						grid.SetGridValues(rules.Spread(geometry,
+							RandomRow() & geometry.fullMask));
+						hints.SetBoard(grid.GetGridValues());
+					}
+				}
+
+				if (!same) {
+					fprintf(stderr, "%s hints are wrong on %dx%d\n",
+						rules.Name(), n, n);
+					identical = false;
+				}
+			}
+		}
+	}
+
+	return identical;
+}
+
+
+static ModularBoard
+RandomModularBoard(int8 n, int8 numStates)
+{
+	ModularBoard board(n, numStates);
+	for (int32 offset = 0; offset < n * n; offset++)
+		board.SetValue(offset, sRandom.Uniform(numStates));
+
+	return board;
+}
+
+
+/*
+ * Compare pressing a whole board of press counts with pressing the buttons
+ * one at a time, and check that the solver's solutions turn every light off
+ * on boards that were made by pressing buttons.
+ */
+
+static bool
+CheckModular()
+{
+	bool identical = true;
+
+	for (int8 numStates = 2; numStates <= ModularBoard::kMaxStates;
+			numStates++) {
+		for (int8 n = 1; n <= ModularBoard::MaxDimension(numStates);
+				n += n < 8 ? 1 : 8) {
+			const ModularSolver solver(n, numStates);
+			bool same = true;
+
+			for (int32 round = 0; round < 4; round++) {
+				const ModularBoard presses = RandomModularBoard(n, numStates);
+				ModularBoard lights = RandomModularBoard(n, numStates);
+				ModularBoard expected = lights;
+
+				lights.PressAll(presses);
+				for (int32 offset = 0; offset < n * n; offset++)
+					expected.Press(offset, presses.ValueAt(offset));
+
+				same = same && lights == expected;
+
+				ModularBoard solution;
+				lights.Clear();
+				lights.PressAll(presses);
+				same = same && solver.Solve(lights, solution);
+
+				lights.PressAll(solution);
+				same = same && lights.IsZero();
+			}
+
+			if (!same) {
+				fprintf(stderr, "%d state boards fail on %dx%d\n",
+					(int) numStates, n, n);
+				identical = false;
+			}
+		}
+	}
+
+	return identical;
+}
+
+
+static void
+ModularBenchmarks()
+{
+	for (int32 index = 0; index < numModularStates; index++) {
+		const int8 numStates = modularStates[index];
+
+		for (int8 n = 5; n <= ModularBoard::MaxDimension(numStates); n *= 2) {
+			ModularBoard lights = RandomModularBoard(n, numStates);
+			const ModularBoard presses = RandomModularBoard(n, numStates);
+			ModularBoard other = RandomModularBoard(n, numStates);
+
+			Benchmark(Name("ModularBoard::PressAll", n, numStates), [&]() {
+				lights.PressAll(presses);
+				Use(lights);
+			});
+
+			Benchmark(Name("ModularBoard::operator+=", n, numStates), [&]() {
+				lights += other;
+				Use(lights);
+			});
+
+			const ModularSolver solver(n, numStates);
+			lights.Clear();
+			lights.PressAll(presses);
+
+			Benchmark(Name("ModularSolver::Solve", n, numStates), [&]() {
+				ModularBoard solution;
+				Use(solver.Solve(lights, solution));
+				Use(solution);
+			});
+		}
+	}
+}
+
+
+static void
+KernelBenchmarks()
+{
+	static const int8 dimensions[] = { 16, 32, 64 };
+
+	for (int32 index = 0; index < CountBoardKernels(); index++) {
+		const board_kernels& kernels = BoardKernelsAt(index);
+
+		for (size_t d = 0; d < sizeof(dimensions) / sizeof(dimensions[0]);
+				d++) {
+			const int8 n = dimensions[d];
+			const uint64 rowMask = n == 64 ? ~(uint64) 0 : ((uint64) 1 << n) - 1;
+			uint64 rows[Board::kMaxDimension];
+			uint64 presses[Board::kMaxDimension];
+
+			for (int8 y = 0; y < n; y++) {
+				rows[y] = RandomRow() & rowMask;
+				presses[y] = RandomRow() & rowMask;
+			}
+
+			std::string name = std::string("/") + kernels.name;
+
+			Benchmark(Name("PressRows", n) + name, [&]() {
+				kernels.PressRows(rows, presses, n, rowMask);
+				Use(rows);
+			});
+
+			Benchmark(Name("XorRows", n) + name, [&]() {
+				kernels.XorRows(rows, presses, n);
+				Use(rows);
+			});
+
+			Benchmark(Name("IsZero", n) + name, [&]() {
+				Use(kernels.IsZero(rows, n));
+			});
+		}
+	}
+}
+
+
+int
+main(int argc, char** argv)
+{
+	for (int arg = 1; arg < argc; arg++) {
+		if (strcmp(argv[arg], "-csv") == 0)
+			sCSV = true;
+		else if (strcmp(argv[arg], "-t") == 0 && arg + 1 < argc)
+			sMinTime = atof(argv[++arg]) * 1e6;
+		else
+			sPrefix = argv[arg];
+	}
+
+	if (sCSV)
+		printf("name,iterations,ns_per_op,allocs_per_op\n");
+	else
+		printf("%-32s %12s %12s %10s\n", "benchmark", "iterations", "ns/op",
+			"allocs/op");
+
+	if (!CheckKernels() || !CheckRules() || !CheckHints() || !CheckModular())
+		return 1;
+
+	GridBenchmarks();
+	HistoryBenchmarks();
+	RandomBenchmarks();
+	PackBenchmarks();
+	SolverBenchmarks();
+	ModularBenchmarks();
+	KernelBenchmarks();
+
+	return 0;
+}
@@ -0,0 +1,881 @@
+/*
+ * Converts puzzles between pack files and text, in either direction. Both
+ * go through buffers of fixed size, so dumps of any size stream through in
+ * constant memory, and every board read from text is checked as it comes
+ * in: boards that can't be solved under the rules of the pack, and move
+ * counts lower than the optimum, are reported and left out.
+ *
+ * Usage: PackConverter [-f hex|csv|grid] [-d dimension] [-r rules]
+ *		[-n name] [-t threads] input output
+ *	-f	the text format, hex by default
+ *	-d	the dimension of hex and csv boards, 5 by default
+ *	-r	the rules of the pack, as named by Rules::Name(), plus by default
+ *	-n	the name of the pack, the name of the input file by default
+ *	-t	the threads to check boards on, one per core by default
+ *
+ * Boards are read in batches, and each batch is checked on all threads
+ * before it is written. Only the checking is spread over the threads:
+ * reading and writing take some 40 ns a board on one, against 80 to 120 ns
+ * for checking a 4x4 or 5x5 board, so beyond two or three threads, dumps of
+ * small boards convert no faster than they can be read and written.
+ *
+ * If input is a pack file, it is written to output as text; otherwise input
+ * is read as text and written to output as a pack file. Text may be read
+ * from and written to "-" for standard input and output.
+ *
+ * The formats are:
+ *	hex		boards in hex in the layout of Grid::GetGridValues(), with or
+ *			without "0x", separated by commas or white space, so the arrays
+ *			of PuzzlePack.cpp can be read as they are
+ *	csv		one "board,moves" line per puzzle, the board in hex, as
+ *			BatchGenerator writes them
+ *	grid	one line per row of the board, with any of "#*Oo1" for a light
+ *			that is on and any of ".-0" for one that is off; boards may be
+ *			separated by blank lines, and their dimension is that of the
+ *			first row
+ * Lines of hex and csv input that don't start with a number, like headers
+ * and declarations, are skipped, except that an array of "0x" numbers is
+ * read from its opening brace on, even on the line that declares it. Boards
+ * read without a move count take their optimal one.
+ */
+
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Grid.h"
+#include "HintEngine.h"
+#include "PuzzlePack.h"
+
+// large enough for the longest line any of the formats needs
+static const size_t bufferSize = 1024 * 1024;
+
+// the boards read before they are checked and written
+static const size_t batchSize = 64 * 1024;
+
+// the problems reported one by one; the rest are only counted
+static const uint64 maxReports = 20;
+
+enum text_format {
+	kHexFormat,
+	kCsvFormat,
+	kGridFormat
+};
+
+// the value of every character as a hex digit, or -1
+static int8 sHexDigits[256];
+// whether every character is a light that is on (1), off (0), or neither
+static int8 sLights[256];
+
+
+static void
+InitTables()
+{
+	memset(sHexDigits, -1, sizeof(sHexDigits));
+	for (int32 digit = 0; digit < 16; digit++) {
+		sHexDigits[(uint8) "0123456789abcdef"[digit]] = digit;
+		sHexDigits[(uint8) "0123456789ABCDEF"[digit]] = digit;
+	}
+
+	memset(sLights, -1, sizeof(sLights));
+	for (const char* on = "#*Oo1"; *on != '\0'; on++)
+		sLights[(uint8) *on] = 1;
+	for (const char* off = ".-0"; *off != '\0'; off++)
+		sLights[(uint8) *off] = 0;
+}
+
+
+struct batch_entry {
+	uint64	board;
+	uint64	line;
+	int32	moves;		// or -1 if not given
+	int32	optimal;	// or -1 if the board can't be solved
+};
+
+
+static void
+CheckBoards(HintEngine& hints, batch_entry* entries, size_t count)
+{
+	for (size_t index = 0; index < count; index++) {
+		hints.SetBoard(entries[index].board);
+		entries[index].optimal = hints.MovesRemaining();
+	}
+}
+
+
+static bool
+IsSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+
+static const char*
+SkipSpace(const char* text, const char* end)
+{
+	while (text < end && IsSpace(*text))
+		text++;
+	return text;
+}
+
+
+/*
+ * Read a hex number of at most 16 digits, with or without "0x", from text,
+ * and return where it ends, or NULL if there is none.
+ */
+
+static const char*
+ParseHex(const char* text, const char* end, uint64& value)
+{
+	if (end - text > 2 && text[0] == '0' && (text[1] | 0x20) == 'x')
+		text += 2;
+
+	const char* start = text;
+	uint64 number = 0;
+	int8 digit;
+
+	while (text < end && (digit = sHexDigits[(uint8) *text]) >= 0) {
+		number = number << 4 | digit;
+		text++;
+	}
+
+	if (text == start || text - start > 16)
+		return NULL;
+
+	value = number;
+	return text;
+}
+
+
+static const char*
+ParseDecimal(const char* text, const char* end, uint32& value)
+{
+	const char* start = text;
+	uint32 number = 0;
+
+	while (text < end && *text >= '0' && *text <= '9' && text - start < 9)
+		number = number * 10 + (*text++ - '0');
+
+	if (text == start)
+		return NULL;
+
+	value = number;
+	return text;
+}
+
+
+class Importer
+{
+public:
+	Importer(const char* inputName, const char* path, const char* name,
+		text_format format, int8 dimension, const Rules& rules,
+		int32 numThreads);
+
+	void Line(const char* text, const char* end);
+	status_t Close();
+
+	uint64 CountPuzzles() const { return fWriter.CountPuzzles(); }
+	uint64 CountRejected() const { return fNumRejected; }
+
+private:
+	void _HexLine(const char* text, const char* end);
+	void _CsvLine(const char* text, const char* end);
+	void _GridLine(const char* text, const char* end);
+
+	void _Add(uint64 board, int32 moves);
+	void _CheckBatch();
+	void _Reject(uint64 line, const char* format, ...)
+		__attribute__((format(printf, 3, 4)));
+
+	const char*	fInputName;
+	text_format	fFormat;
+	int8		fDimension;
+	Rules		fRules;
+	uint64		fLine;
+
+	std::string	fPath;
+	std::string	fName;
+	PackWriter	fWriter;
+	bool		fIsOpen;
+	status_t	fStatus;
+	uint64		fNumRejected;
+
+	std::vector<HintEngine>		fHints;
+	std::vector<batch_entry>	fBatch;
+
+	// the grid being read, and its rows so far or -1 if it is skipped
+	uint64		fGrid;
+	int8		fNumRows;
+};
+
+
+/*
+ * An importer of the text from inputName into a pack file at path. The file
+ * is only created with the first board, once the dimension of grids is
+ * known.
+ */
+
+Importer::Importer(const char* inputName, const char* path,
+	const char* name, text_format format, int8 dimension, const Rules& rules,
+	int32 numThreads)
+	:
+	fInputName(inputName),
+	fFormat(format),
+	fDimension(format == kGridFormat ? 0 : dimension),
+	fRules(rules),
+	fLine(0),
+	fPath(path),
+	fName(name),
+	fIsOpen(false),
+	fStatus(B_OK),
+	fNumRejected(0),
+	fHints(numThreads),
+	fGrid(0),
+	fNumRows(0)
+{
+	fBatch.reserve(batchSize);
+}
+
+/*
+ * Read the line of text up to end, which doesn't include the newline.
+ */
+
+void Importer::Line(const char* text, const char* end)
+{
+	fLine++;
+
+	switch (fFormat) {
+		case kHexFormat:
+			_HexLine(text, end);
+			break;
+		case kCsvFormat:
+			_CsvLine(text, end);
+			break;
+		case kGridFormat:
+			_GridLine(text, end);
+			break;
+	}
+}
+
+/*
+ * Finish the pack, even if it ended up empty.
+ */
+
+status_t Importer::Close()
+{
+	if (fNumRows > 0)
+		_Reject(fLine, "board ends after %d rows", (int) fNumRows);
+
+	_CheckBatch();
+
+	if (!fIsOpen && fStatus == B_OK) {
+		fStatus = fWriter.Open(fPath.c_str(), fName.c_str(),
+			fDimension > 0 ? fDimension : 5, fRules);
+	}
+
+	if (fStatus != B_OK) {
+		fWriter.Close();
+		return fStatus;
+	}
+
+	return fWriter.Close();
+}
+
+void Importer::_HexLine(const char* text, const char* end)
+{
+	// the boards of an array start after its brace, even on the line that
+	// declares it, and end at the closing one; arrays of anything but "0x"
+	// numbers aren't boards
+	const char* brace = (const char*) memchr(text, '{', end - text);
+	if (brace != NULL) {
+		text = SkipSpace(brace + 1, end);
+		if (end - text < 2 || text[0] != '0' || (text[1] | 0x20) != 'x')
+			return;
+	}
+
+	bool isFirst = brace == NULL;
+
+	for (;;) {
+		text = SkipSpace(text, end);
+		if (text == end || *text == '}')
+			return;
+
+		uint64 board;
+		const char* next = ParseHex(text, end, board);
+		if (next != NULL && next < end && !IsSpace(*next) && *next != ',')
+			next = NULL;
+
+		if (next == NULL) {
+			// unless it starts like one, not a line of boards
+			if (!isFirst || (*text >= '0' && *text <= '9'))
+				_Reject(fLine, "not a board in hex");
+			return;
+		}
+
+		_Add(board, -1);
+
+		text = SkipSpace(next, end);
+		if (text < end && *text == ',')
+			text++;
+
+		isFirst = false;
+	}
+}
+
+void Importer::_CsvLine(const char* text, const char* end)
+{
+	text = SkipSpace(text, end);
+
+	uint64 board;
+	const char* next = ParseHex(text, end, board);
+	if (next == NULL || (next < end && *next != ',' && !IsSpace(*next))) {
+		// unless it starts like one, a header rather than a board
+		if (text < end && *text >= '0' && *text <= '9')
+			_Reject(fLine, "not a board in hex");
+		return;
+	}
+
+	text = SkipSpace(next, end);
+	if (text == end) {
+		_Add(board, -1);
+		return;
+	}
+
+	uint32 moves;
+	if (*text != ',' || (next = ParseDecimal(SkipSpace(text + 1, end), end,
+			moves)) == NULL || SkipSpace(next, end) != end || moves > 255) {
+		_Reject(fLine, "not a board and move count");
+		return;
+	}
+
+	_Add(board, moves);
+}
+
+void Importer::_GridLine(const char* text, const char* end)
+{
+	text = SkipSpace(text, end);
+	while (end > text && IsSpace(end[-1]))
+		end--;
+
+	if (text == end) {
+		if (fNumRows > 0)
+			_Reject(fLine, "board ends after %d rows", (int) fNumRows);
+
+		fNumRows = 0;
+		fGrid = 0;
+		return;
+	}
+
+	if (fNumRows < 0)
+		return;
+
+	if (fDimension == 0) {
+		if (end - text > 8) {
+			_Reject(fLine, "row of more than 8 lights");
+			fNumRows = -1;
+			return;
+		}
+
+		fDimension = end - text;
+	}
+
+	if (end - text != fDimension) {
+		_Reject(fLine, "row of %d lights on a %dx%d board", (int) (end - text),
+			(int) fDimension, (int) fDimension);
+		fNumRows = -1;
+		return;
+	}
+
+	uint64 row = 0;
+	for (int32 x = 0; x < fDimension; x++) {
+		const int8 light = sLights[(uint8) text[x]];
+		if (light < 0) {
+			_Reject(fLine, "'%c' is not a light", text[x]);
+			fNumRows = -1;
+			return;
+		}
+
+		row |= (uint64) light << x;
+	}
+
+	fGrid |= row << (fNumRows * fDimension);
+
+	if (++fNumRows == fDimension) {
+		_Add(fGrid, -1);
+		fNumRows = 0;
+		fGrid = 0;
+	}
+}
+
+/*
+ * Queue board to be added to the pack if it can be solved in moves moves,
+ * or -1 for its optimal number of them.
+ */
+
+void Importer::_Add(uint64 board, int32 moves)
+{
+	if (fStatus != B_OK)
+		return;
+
+	if (!fIsOpen) {
+		fStatus = fWriter.Open(fPath.c_str(), fName.c_str(), fDimension,
+			fRules);
+		if (fStatus != B_OK)
+			return;
+
+		Grid grid(fDimension);
+		grid.SetRules(fRules);
+		for (size_t index = 0; index < fHints.size(); index++)
+			fHints[index].Start(grid);
+
+		fIsOpen = true;
+	}
+
+	const int32 bits = fDimension * fDimension;
+	if (bits < 64 && (board >> bits) != 0) {
+		_Reject(fLine, "0x%llx is too large for a %dx%d board",
+			(unsigned long long) board, (int) fDimension, (int) fDimension);
+		return;
+	}
+
+	batch_entry entry = { board, fLine, moves, -1 };
+	fBatch.push_back(entry);
+
+	if (fBatch.size() == batchSize)
+		_CheckBatch();
+}
+
+/*
+ * Solve the boards queued on every thread, and write those that pass.
+ */
+
+void Importer::_CheckBatch()
+{
+	const size_t numThreads = fHints.size();
+	const size_t chunk = (fBatch.size() + numThreads - 1) / numThreads;
+
+	std::vector<std::thread> workers;
+	for (size_t begin = 0, thread = 0; begin < fBatch.size();
+			begin += chunk, thread++) {
+		const size_t count = begin + chunk < fBatch.size()
+			? chunk : fBatch.size() - begin;
+
+		if (numThreads == 1)
+			CheckBoards(fHints[0], &fBatch[begin], count);
+		else {
+			workers.push_back(std::thread(CheckBoards,
+				std::ref(fHints[thread]), &fBatch[begin], count));
+		}
+	}
+
+	for (size_t index = 0; index < workers.size(); index++)
+		workers[index].join();
+
+	for (size_t index = 0; index < fBatch.size() && fStatus == B_OK;
+			index++) {
+		const batch_entry& entry = fBatch[index];
+
+		if (entry.optimal < 0) {
+			_Reject(entry.line, "0x%llx can't be solved",
+				(unsigned long long) entry.board);
+		} else if (entry.moves >= 0 && entry.moves < entry.optimal) {
+			_Reject(entry.line, "0x%llx takes %d moves, not %d",
+				(unsigned long long) entry.board, (int) entry.optimal,
+				(int) entry.moves);
+		} else {
+			fStatus = fWriter.Add(entry.board,
+				entry.moves >= 0 ? entry.moves : entry.optimal);
+		}
+	}
+
+	fBatch.clear();
+}
+
+void Importer::_Reject(uint64 line, const char* format, ...)
+{
+	if (fNumRejected++ >= maxReports)
+		return;
+
+	fprintf(stderr, "%s:%llu: ", fInputName, (unsigned long long) line);
+
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+
+	fputc('\n', stderr);
+}
+
+
+/*
+ * Read the text from fd a buffer at a time and hand it to importer line by
+ * line, or return how reading failed.
+ */
+
+static status_t
+ReadLines(int fd, Importer& importer, uint64& size)
+{
+	char* buffer = new char[bufferSize];
+	size_t kept = 0;
+	status_t status = B_OK;
+
+	size = 0;
+
+	for (;;) {
+		const ssize_t bytesRead = read(fd, buffer + kept, bufferSize - kept);
+		if (bytesRead < 0) {
+			if (errno == EINTR)
+				continue;
+
+			status = B_FROM_POSIX_ERROR(errno);
+			break;
+		}
+
+		size += bytesRead;
+
+		const char* end = buffer + kept + bytesRead;
+		if (memchr(buffer + kept, '\0', bytesRead) != NULL) {
+			status = B_BAD_DATA;
+			break;
+		}
+
+		const char* line = buffer;
+		while (const char* newline
+				= (const char*) memchr(line, '\n', end - line)) {
+			importer.Line(line, newline);
+			line = newline + 1;
+		}
+
+		if (bytesRead == 0) {
+			// the last line has no newline
+			if (line < end)
+				importer.Line(line, end);
+			break;
+		}
+
+		kept = end - line;
+		if (kept == bufferSize) {
+			status = B_BAD_DATA;
+			break;
+		}
+
+		memmove(buffer, line, kept);
+	}
+
+	delete[] buffer;
+	return status;
+}
+
+
+class Exporter
+{
+public:
+	Exporter(int fd, text_format format, int8 dimension);
+	~Exporter();
+
+	void Add(uint64 board, uint8 moves)
+	{
+		// room for the largest grid
+		if (fUsed + 80 > bufferSize)
+			_Flush();
+
+		switch (fFormat) {
+			case kHexFormat:
+				fBuffer[fUsed++] = '0';
+				fBuffer[fUsed++] = 'x';
+				_AddHex(board, fNumDigits);
+				fBuffer[fUsed++] = '\n';
+				break;
+			case kCsvFormat:
+				_AddHex(board, board != 0
+					? (67 - __builtin_clzll(board)) / 4 : 1);
+				fBuffer[fUsed++] = ',';
+				_AddDecimal(moves);
+				fBuffer[fUsed++] = '\n';
+				break;
+			case kGridFormat:
+				_AddGrid(board);
+				break;
+		}
+	}
+
+	status_t Close();
+
+	uint64 CountBytes() const { return fNumBytes; }
+
+private:
+	void _AddHex(uint64 value, int32 numDigits)
+	{
+		for (int32 digit = numDigits - 1; digit >= 0; digit--) {
+			fBuffer[fUsed + digit] = "0123456789abcdef"[value & 0xf];
+			value >>= 4;
+		}
+		fUsed += numDigits;
+	}
+
+	void _AddDecimal(uint8 value)
+	{
+		if (value >= 100)
+			fBuffer[fUsed++] = '0' + value / 100;
+		if (value >= 10)
+			fBuffer[fUsed++] = '0' + value / 10 % 10;
+		fBuffer[fUsed++] = '0' + value % 10;
+	}
+
+	void _AddGrid(uint64 board);
+	void _Flush();
+
+	int			fFD;
+	text_format	fFormat;
+	int8		fDimension;
+	int32		fNumDigits;
+	char*		fBuffer;
+	size_t		fUsed;
+	uint64		fNumBytes;
+	status_t	fStatus;
+};
+
+
+Exporter::Exporter(int fd, text_format format, int8 dimension)
+	:
+	fFD(fd),
+	fFormat(format),
+	fDimension(dimension),
+	fNumDigits((dimension * dimension + 3) / 4),
+	fBuffer(new char[bufferSize]),
+	fUsed(0),
+	fNumBytes(0),
+	fStatus(B_OK)
+{
+}
+
+Exporter::~Exporter()
+{
+	delete[] fBuffer;
+}
+
+status_t Exporter::Close()
+{
+	_Flush();
+	return fStatus;
+}
+
+void Exporter::_AddGrid(uint64 board)
+{
+	for (int32 y = 0; y < fDimension; y++) {
+		for (int32 x = 0; x < fDimension; x++, board >>= 1)
+			fBuffer[fUsed++] = (board & 1) != 0 ? '#' : '.';
+		fBuffer[fUsed++] = '\n';
+	}
+
+	fBuffer[fUsed++] = '\n';
+}
+
+void Exporter::_Flush()
+{
+	for (size_t written = 0; written < fUsed && fStatus == B_OK;) {
+		const ssize_t bytesWritten = write(fFD, fBuffer + written,
+			fUsed - written);
+		if (bytesWritten < 0 && errno != EINTR)
+			fStatus = B_FROM_POSIX_ERROR(errno);
+		else if (bytesWritten > 0)
+			written += bytesWritten;
+	}
+
+	fNumBytes += fUsed;
+	fUsed = 0;
+}
+
+
+static bool
+ParseRules(const char* name, Rules& rules)
+{
+	for (int32 shape = 0; shape < kNumNeighbourhoods; shape++) {
+		for (int32 toroidal = 0; toroidal < 2; toroidal++) {
+			Rules candidate((neighbourhood) shape, toroidal != 0);
+			if (strcmp(candidate.Name(), name) == 0) {
+				rules = candidate;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+
+/*
+ * The name of the pack read from path: its file name without extension.
+ */
+
+static std::string
+PackName(const char* path)
+{
+	if (strcmp(path, "-") == 0)
+		return "Imported puzzles";
+
+	const char* slash = strrchr(path, '/');
+	std::string name = slash != NULL ? slash + 1 : path;
+
+	const size_t dot = name.rfind('.');
+	if (dot != std::string::npos && dot > 0)
+		name.erase(dot);
+
+	return name;
+}
+
+
+static void
+Usage()
+{
+	fprintf(stderr, "usage: PackConverter [-f hex|csv|grid] [-d dimension] "
+		"[-r rules] [-n name] [-t threads] input output\n");
+	exit(2);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	text_format format = kHexFormat;
+	int8 dimension = 5;
+	Rules rules;
+	const char* name = NULL;
+	int32 numThreads = std::thread::hardware_concurrency();
+
+	int option;
+	while ((option = getopt(argc, argv, "f:d:r:n:t:")) != -1) {
+		switch (option) {
+			case 'f':
+				if (strcmp(optarg, "hex") == 0)
+					format = kHexFormat;
+				else if (strcmp(optarg, "csv") == 0)
+					format = kCsvFormat;
+				else if (strcmp(optarg, "grid") == 0)
+					format = kGridFormat;
+				else
+					Usage();
+				break;
+			case 'd':
+				dimension = atoi(optarg);
+				break;
+			case 'r':
+				if (!ParseRules(optarg, rules))
+					Usage();
+				break;
+			case 'n':
+				name = optarg;
+				break;
+			case 't':
+				numThreads = atoi(optarg);
+				break;
+			default:
+				Usage();
+		}
+	}
+
+	if (argc - optind != 2 || dimension < 1 || dimension > 8
+		|| (rules.IsToroidal() && dimension < 3))
+		Usage();
+
+	if (numThreads < 1)
+		numThreads = 1;
+
+	const char* input = argv[optind];
+	const char* output = argv[optind + 1];
+
+	InitTables();
+
+	const std::chrono::steady_clock::time_point start
+		= std::chrono::steady_clock::now();
+
+	PuzzlePack pack;
+	const bool isExport = strcmp(input, "-") != 0
+		&& pack.Open(input) == B_OK;
+
+	uint64 size = 0;
+	uint64 numPuzzles = 0;
+	uint64 numRejected = 0;
+	status_t status;
+
+	if (isExport) {
+		status = pack.Verify();
+		if (status != B_OK) {
+			fprintf(stderr, "%s: %s\n", input,
+				strerror(B_TO_POSIX_ERROR(status)));
+			return 1;
+		}
+
+		int fd = strcmp(output, "-") == 0 ? STDOUT_FILENO
+			: open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0) {
+			perror(output);
+			return 1;
+		}
+
+		Exporter exporter(fd, format, pack.Dimension());
+		for (uint32 index = 0; index < pack.Size(); index++)
+			exporter.Add(pack.ValueAt(index), pack.MovesRequired(index));
+
+		status = exporter.Close();
+		if (fd != STDOUT_FILENO && close(fd) != 0 && status == B_OK)
+			status = B_FROM_POSIX_ERROR(errno);
+
+		numPuzzles = pack.Size();
+		size = exporter.CountBytes();
+
+		fprintf(stderr, "%s: %dx%d, %s\n", input, (int) pack.Dimension(),
+			(int) pack.Dimension(), pack.GetRules().Name());
+	} else {
+		int fd = strcmp(input, "-") == 0 ? STDIN_FILENO
+			: open(input, O_RDONLY);
+		if (fd < 0) {
+			perror(input);
+			return 1;
+		}
+
+		const std::string packName = name != NULL ? name : PackName(input);
+
+		Importer importer(input, output, packName.c_str(), format, dimension,
+			rules, numThreads);
+		status = ReadLines(fd, importer, size);
+
+		if (fd != STDIN_FILENO)
+			close(fd);
+
+		if (status == B_BAD_DATA) {
+			fprintf(stderr, "%s: not a pack file, nor text with lines of "
+				"at most %zu bytes\n", input, bufferSize);
+		}
+
+		status_t closeStatus = importer.Close();
+		if (status == B_OK)
+			status = closeStatus;
+
+		numPuzzles = importer.CountPuzzles();
+		numRejected = importer.CountRejected();
+	}
+
+	if (status != B_OK && status != B_BAD_DATA) {
+		fprintf(stderr, "%s: %s\n", output,
+			strerror(B_TO_POSIX_ERROR(status)));
+	}
+
+	const std::chrono::duration<double> elapsed
+		= std::chrono::steady_clock::now() - start;
+
+	fprintf(stderr, "%llu puzzles, %llu rejected: %.1f MB in %.2f s "
+		"(%.0f MB/s)\n", (unsigned long long) numPuzzles,
+		(unsigned long long) numRejected, size / 1e6, elapsed.count(),
+		size / 1e6 / elapsed.count());
+
+	return status != B_OK || numRejected > 0 ? 1 : 0;
+}
@@ -0,0 +1,217 @@
+/*
+ * Solves every board of the built-in puzzle packs, and of any pack files
+ * given, and reports the optimal number of moves, boards that can't be
+ * solved, boards that appear more than once, and levels whose declared move
+ * count doesn't match the optimum. Pack files are also checked against
+ * their checksum.
+ *
+ * Usage: PackValidator [-v] [-w directory] [threads] [pack file...]
+ *	-v	list the optimal move count of every level
+ *	-w	write every pack to directory/<name>.pack, in the pack file format
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "ChaseSolver.h"
+#include "Grid.h"
+#include "HintEngine.h"
+#include "PuzzlePack.h"
+
+
+struct Level {
+	PuzzlePack*	pack;
+	int32	packIndex;
+	uint32	index;
+	uint64	board;
+	int32	declared;
+	int32	optimal;
+};
+
+
+static int32
+MinimumMoves(PuzzlePack* pack, uint64 board)
+{
+	const Rules rules = pack->GetRules();
+	if (rules.IsClassic())
+		return ChaseSolver::ForDimension(pack->Dimension()).MinimumMoves(board);
+
+	Grid grid(pack->Dimension());
+	grid.SetRules(rules);
+	grid.SetGridValues(board);
+
+	HintEngine hints;
+	hints.Start(grid);
+	return hints.MovesRemaining();
+}
+
+
+static void
+SolveLevels(std::vector<Level>& levels, size_t begin, size_t end)
+{
+	for (size_t index = begin; index < end; index++)
+		levels[index].optimal = MinimumMoves(levels[index].pack,
+			levels[index].board);
+}
+
+
+static bool
+IsNumber(const char* string)
+{
+	return string[0] != '\0' && strspn(string, "0123456789") == strlen(string);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	bool verbose = false;
+	const char* writeDirectory = NULL;
+	int32 numThreads = std::thread::hardware_concurrency();
+	int32 corrupt = 0;
+
+	PuzzlePackSet packs;
+
+	for (int arg = 1; arg < argc; arg++) {
+		if (strcmp(argv[arg], "-v") == 0)
+			verbose = true;
+		else if (strcmp(argv[arg], "-w") == 0 && arg + 1 < argc)
+			writeDirectory = argv[++arg];
+		else if (IsNumber(argv[arg]))
+			numThreads = atoi(argv[arg]);
+		else {
+			status_t status = packs.AddPack(argv[arg]);
+			if (status == B_OK)
+				status = packs.PackAt(packs.CountPacks() - 1)->Verify();
+
+			if (status != B_OK) {
+				printf("CORRUPT     %s: %s\n", argv[arg],
+					strerror(B_TO_POSIX_ERROR(status)));
+				corrupt++;
+			}
+		}
+	}
+
+	if (numThreads < 1)
+		numThreads = 1;
+
+	const std::chrono::steady_clock::time_point start
+		= std::chrono::steady_clock::now();
+
+	std::vector<Level> levels;
+
+	for (int32 pack = 0; pack < packs.CountPacks(); pack++) {
+		PuzzlePack* puzzles = packs.PackAt(pack);
+
+		for (uint32 index = 0; index < puzzles->Size(); index++) {
+			Level level = { puzzles, pack, index, puzzles->ValueAt(index),
+				puzzles->MovesRequired(index), -1 };
+			levels.push_back(level);
+		}
+	}
+
+	std::vector<std::thread> workers;
+	const size_t chunk = (levels.size() + numThreads - 1) / numThreads;
+
+	for (size_t begin = 0; begin < levels.size(); begin += chunk) {
+		const size_t end = begin + chunk < levels.size()
+			? begin + chunk : levels.size();
+		workers.push_back(std::thread(SolveLevels, std::ref(levels), begin,
+			end));
+	}
+
+	for (size_t index = 0; index < workers.size(); index++)
+		workers[index].join();
+
+	const std::chrono::duration<double, std::milli> elapsed
+		= std::chrono::steady_clock::now() - start;
+
+	int32 unsolvable = 0;
+	int32 mismatches = 0;
+	int32 duplicates = 0;
+	std::map<uint64, size_t> firstSeen;
+
+	for (size_t index = 0; index < levels.size(); index++) {
+		const Level& level = levels[index];
+		const char* packName = level.pack->Name();
+
+		if (verbose)
+			printf("%s, level %u: %d moves (declared %d)\n", packName,
+				level.index + 1, level.optimal, level.declared);
+
+		if (level.optimal < 0) {
+			printf("UNSOLVABLE  %s, level %u: 0x%llx\n", packName,
+				level.index + 1, (unsigned long long) level.board);
+			unsolvable++;
+		} else if (level.optimal != level.declared) {
+			printf("MISMATCH    %s, level %u: declared %d, optimal %d\n",
+				packName, level.index + 1, level.declared, level.optimal);
+			mismatches++;
+		}
+
+		std::map<uint64, size_t>::iterator seen = firstSeen.find(level.board);
+		if (seen != firstSeen.end()) {
+			const Level& first = levels[seen->second];
+			printf("DUPLICATE   %s, level %u: same as %s, level %u\n",
+				packName, level.index + 1, first.pack->Name(),
+				first.index + 1);
+			duplicates++;
+		} else
+			firstSeen[level.board] = index;
+	}
+
+	printf("\n%-24s %6s %6s %6s %6s\n", "pack", "levels", "min", "max",
+		"bad");
+
+	for (int32 pack = 0; pack < packs.CountPacks(); pack++) {
+		int32 count = 0, bad = 0, minMoves = 0, maxMoves = 0;
+
+		for (size_t index = 0; index < levels.size(); index++) {
+			const Level& level = levels[index];
+			if (level.packIndex != pack)
+				continue;
+
+			if (count == 0 || level.optimal < minMoves)
+				minMoves = level.optimal;
+			if (count == 0 || level.optimal > maxMoves)
+				maxMoves = level.optimal;
+			if (level.optimal != level.declared)
+				bad++;
+			count++;
+		}
+
+		printf("%-24s %6d %6d %6d %6d\n", packs.PackAt(pack)->Name(), count,
+			minMoves, maxMoves, bad);
+	}
+
+	printf("\n%d levels, %d unsolvable, %d mismatched, %d duplicates "
+		"(%.2f ms, %d threads)\n", (int) levels.size(), unsolvable, mismatches,
+		duplicates, elapsed.count(), numThreads);
+
+	if (writeDirectory != NULL) {
+		for (int32 pack = 0; pack < packs.CountPacks(); pack++) {
+			PuzzlePack* puzzles = packs.PackAt(pack);
+
+			char path[PATH_MAX];
+			snprintf(path, sizeof(path), "%s/%s.pack", writeDirectory,
+				puzzles->Name());
+
+			status_t status = PuzzlePack::Write(path, *puzzles);
+			if (status != B_OK) {
+				fprintf(stderr, "%s: %s\n", path,
+					strerror(B_TO_POSIX_ERROR(status)));
+				corrupt++;
+			}
+		}
+	}
+
+	return unsolvable == 0 && mismatches == 0 && duplicates == 0
+		&& corrupt == 0 ? 0 : 1;
+}
@@ -0,0 +1,328 @@
+/*
+ * Plays session logs back without the user interface and checks that every
+ * puzzle comes out the way the log says it did.
+ *
+ * Usage: SessionReplayer [-q] [-d directory] [-p directory] log...
+ *	SessionReplayer [-d directory] [-p directory] -g count directory
+ *	Replaying prints each log that fails and a summary; -q leaves out the
+ *	summary. With -g, count logs of sessions played by a simple bot are
+ *	written to directory/session-N instead, to have something to replay,
+ *	and each is replayed as soon as it is written.
+ *	-d maps the distance databases of directory to draw random puzzles from,
+ *	as the game does, instead of enumerating 5x5 first.
+ *	-p adds the pack files of directory to the built-in packs, as the game
+ *	does with those in its packs directory, so that sessions played on them
+ *	replay, and the bot plays them as well.
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include "Grid.h"
+#include "MoveHistory.h"
+#include "PackCatalogue.h"
+#include "PuzzleGenerator.h"
+#include "PuzzlePack.h"
+#include "Random.h"
+#include "SessionLog.h"
+#include "SessionReplayer.h"
+#include "Solver.h"
+
+// levels offered by the Random menu for dimensions 3x3 through 8x8
+static const int8 minDimension = 3;
+static const int8 maxDimension = 8;
+static const int8 maxLevels[] = { 8, 7, 15, 35, 48, 63 };
+
+static const int32 maxPuzzlesPerSession = 20;
+
+
+static bool
+ReadFile(const char* path, std::vector<uint8>& data)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return false;
+
+	data.clear();
+
+	uint8 buffer[65536];
+	size_t bytesRead;
+	while ((bytesRead = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		data.insert(data.end(), buffer, buffer + bytesRead);
+
+	const bool isOk = ferror(file) == 0;
+	fclose(file);
+	return isOk;
+}
+
+
+/*
+ * Play one puzzle the way a somewhat careless player would: the buttons of
+ * a solution in random order, with the odd wrong button that is then taken
+ * back by pressing it again or with undo, and now and then a restart.
+ */
+
+static void
+PlayPuzzle(SessionRecorder& recorder, RandomGenerator& generator,
+	int64& time, PuzzlePack* pack, int32 level, int8 dimension)
+{
+	Grid grid(dimension);
+	uint32 seed = 0;
+
+	// pick the puzzle the way GridView::SetLevel() does
+	if (pack != NULL) {
+		grid.SetRules(pack->GetRules());
+		grid.SetGridValues(pack->ValueAt(level));
+	} else {
+		seed = generator.Next();
+		RandomGenerator puzzleGenerator(seed);
+		grid.Random(level + 1, puzzleGenerator);
+	}
+
+	const uint64 board = grid.GetGridValues();
+	recorder.StartPuzzle(time, dimension, pack != NULL ? pack->Name() : NULL,
+		level, seed, board);
+
+	MoveHistory history;
+	history.Start(grid);
+
+	uint64 presses;
+	if (grid.GetRules().IsClassic())
+		Solver::ForDimension(dimension).Solve(board, presses);
+	else
+		Solver(dimension, grid.GetRules()).Solve(board, presses);
+
+	int8 buttons[64];
+	int32 numButtons = 0;
+	for (int8 offset = 0; offset < dimension * dimension; offset++) {
+		if ((presses >> offset) & 1)
+			buttons[numButtons++] = offset;
+	}
+
+	for (int32 index = 0; index < numButtons; index++) {
+		const int32 other = index + generator.Uniform(numButtons - index);
+		const int8 swap = buttons[index];
+		buttons[index] = buttons[other];
+		buttons[other] = swap;
+	}
+
+	for (int32 index = 0; index < numButtons;) {
+		time += (200 + generator.Uniform(3000)) * 1000;
+
+		const int32 choice = generator.Uniform(20);
+		if (choice == 0 && history.Position() > 0) {
+			recorder.AddEvent(time, kRestartEvent);
+			history.Seek(history.First());
+			index = 0;
+			continue;
+		}
+
+		if (choice == 1) {
+			// a wrong button, and then the same again or undo
+			const int8 button = generator.Uniform(dimension * dimension);
+			if ((presses >> button) & 1)
+				continue;
+
+			recorder.AddPress(time, button);
+			history.PressOrUndo(button);
+
+			time += (200 + generator.Uniform(3000)) * 1000;
+			if (generator.Uniform(2) == 0) {
+				recorder.AddPress(time, button);
+				history.PressOrUndo(button);
+			} else {
+				recorder.AddEvent(time, kUndoEvent);
+				history.Undo();
+			}
+			continue;
+		}
+
+		recorder.AddPress(time, buttons[index]);
+		index++;
+
+		if (!history.PressOrUndo(buttons[index - 1]) && history.Board() == 0)
+			break;
+	}
+
+	time += 100 * 1000;
+	const int32 movesRequired = pack != NULL
+		? pack->MovesRequired(level, CountBits(presses)) : -1;
+	recorder.Finish(time, history.Position(),
+		FinishOutcome(movesRequired, history.Position()));
+}
+
+
+/*
+ * Write count logs of a bot playing puzzles of packs and random ones to
+ * directory, and replay each of them against packs once it is written, so
+ * that the recorder, the replayer and the pack files are checked together.
+ */
+
+static int
+Generate(int32 count, const char* directory, PuzzlePackSet& packs)
+{
+	SessionRecorder recorder;
+	SessionReplayer replayer(packs);
+	std::vector<uint8> data;
+
+	for (int32 session = 0; session < count; session++) {
+		char path[PATH_MAX];
+		snprintf(path, sizeof(path), "%s/session-%d", directory, (int) session);
+
+		recorder.Reset();
+		status_t status = recorder.Open(path);
+		if (status != B_OK) {
+			fprintf(stderr, "%s: %s\n", path,
+				strerror(B_TO_POSIX_ERROR(status)));
+			return 1;
+		}
+
+		RandomGenerator generator(session);
+		int64 time = (int64) generator.Uniform(1 << 30) * 1000;
+
+		const int32 numPuzzles = 1 + generator.Uniform(maxPuzzlesPerSession);
+		for (int32 puzzle = 0; puzzle < numPuzzles; puzzle++) {
+			const int32 choice = generator.Uniform(packs.CountPacks() + 1);
+
+			if (choice < packs.CountPacks()) {
+				PuzzlePack* pack = packs.PackAt(choice);
+				status = pack->Load();
+				if (status != B_OK) {
+					fprintf(stderr, "%s: %s\n", pack->Name(),
+						strerror(B_TO_POSIX_ERROR(status)));
+					return 1;
+				}
+
+				PlayPuzzle(recorder, generator, time, pack,
+					generator.Uniform(pack->Size()), pack->Dimension());
+			} else {
+				const int8 dimension = minDimension
+					+ generator.Uniform(maxDimension - minDimension + 1);
+				PlayPuzzle(recorder, generator, time, NULL,
+					generator.Uniform(maxLevels[dimension - minDimension]),
+					dimension);
+			}
+		}
+
+		recorder.Close();
+
+		if (!ReadFile(path, data)) {
+			fprintf(stderr, "%s: %s\n", path, strerror(errno));
+			return 1;
+		}
+
+		if (replayer.Replay(data.data(), data.size()) != B_OK) {
+			fprintf(stderr, "%s: does not replay as written at offset %zu\n",
+				path, replayer.ErrorOffset());
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 generateCount = -1;
+	bool quiet = false;
+	PuzzlePackSet packs;
+
+	int option;
+	while ((option = getopt(argc, argv, "d:g:p:q")) != -1) {
+		switch (option) {
+			case 'd':
+				PuzzleGenerator::SetDatabaseDirectory(optarg);
+				break;
+			case 'p':
+			{
+				PackCatalogue catalogue;
+				status_t status = catalogue.Scan(optarg, packs);
+				if (status != B_OK) {
+					fprintf(stderr, "%s: %s\n", optarg,
+						strerror(B_TO_POSIX_ERROR(status)));
+					return 1;
+				}
+				break;
+			}
+			case 'g':
+				generateCount = atoi(optarg);
+				break;
+			case 'q':
+				quiet = true;
+				break;
+			default:
+				fprintf(stderr, "usage: SessionReplayer [-q] [-d directory] "
+					"[-p directory] log...\n"
+					"       SessionReplayer [-d directory] [-p directory] "
+					"-g count directory\n");
+				return 2;
+		}
+	}
+
+	if (generateCount >= 0) {
+		if (optind + 1 != argc) {
+			fprintf(stderr, "usage: SessionReplayer [-d directory] "
+				"[-p directory] -g count directory\n");
+			return 2;
+		}
+
+		return Generate(generateCount, argv[optind], packs);
+	}
+
+	SessionReplayer replayer(packs);
+	std::vector<uint8> data;
+
+	int32 numLogs = 0, numFailed = 0;
+	int64 numPuzzles = 0, numSolved = 0, numEvents = 0;
+	std::chrono::steady_clock::duration elapsed(0);
+
+	for (int arg = optind; arg < argc; arg++) {
+		const char* path = argv[arg];
+		if (!ReadFile(path, data)) {
+			fprintf(stderr, "%s: %s\n", path, strerror(errno));
+			numFailed++;
+			continue;
+		}
+
+		const std::chrono::steady_clock::time_point start
+			= std::chrono::steady_clock::now();
+
+		status_t status = replayer.Replay(data.data(), data.size());
+
+		elapsed += std::chrono::steady_clock::now() - start;
+		numLogs++;
+
+		if (status != B_OK) {
+			fprintf(stderr, "%s: %s at offset %zu\n", path,
+				status == B_BAD_DATA ? "malformed event"
+					: "does not replay as recorded", replayer.ErrorOffset());
+			numFailed++;
+			continue;
+		}
+
+		numPuzzles += replayer.CountPuzzles();
+		numSolved += replayer.CountSolved();
+		numEvents += replayer.CountEvents();
+	}
+
+	if (!quiet) {
+		const double seconds
+			= std::chrono::duration<double>(elapsed).count();
+
+		printf("%d logs, %d failed: %lld puzzles, %lld solved, %lld events "
+			"in %.1f ms (%.0f logs/s)\n", (int) numLogs, (int) numFailed,
+			(long long) numPuzzles, (long long) numSolved,
+			(long long) numEvents, seconds * 1e3,
+			seconds > 0 ? numLogs / seconds : 0.0);
+	}
+
+	return numFailed != 0;
+}
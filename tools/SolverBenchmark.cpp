@@ -0,0 +1,162 @@
+/*
+ * Times the elimination and light-chasing solvers against each other on
+ * every dimension from 3x3 to 8x8, and checks that they agree on the optimal
+ * number of moves. The 5x5 boards are those of the built-in puzzle packs;
+ * the other dimensions get as many boards, each the lights left by a random
+ * set of presses. The much slower search solver is checked against them,
+ * and timed once, on the boards that take up to 10 moves.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+#include "ChaseSolver.h"
+#include "Grid.h"
+#include "PuzzlePack.h"
+#include "Random.h"
+#include "SearchSolver.h"
+#include "Solver.h"
+
+static const int8 packDimension = 5;
+static const int8 minDimension = 3;
+static const int8 maxDimension = 8;
+static const int32 defaultRounds = 1000;
+static const int32 maxSearchMoves = 10;
+
+
+template<typename SolverType>
+static double
+TimeSolver(const SolverType& solver, const std::vector<uint64>& boards,
+	int32 rounds, uint64& checksum)
+{
+	const std::chrono::steady_clock::time_point start
+		= std::chrono::steady_clock::now();
+
+	for (int32 round = 0; round < rounds; round++)
+		for (size_t index = 0; index < boards.size(); index++) {
+			uint64 presses = 0;
+			solver.Solve(boards[index], presses);
+			checksum += presses;
+		}
+
+	const std::chrono::duration<double, std::nano> elapsed
+		= std::chrono::steady_clock::now() - start;
+
+	return elapsed.count() / ((double) rounds * boards.size());
+}
+
+
+/*
+ * The lights left by pressing a random set of buttons, so that every board
+ * can be solved.
+ */
+
+static std::vector<uint64>
+RandomBoards(int8 dimension, size_t count)
+{
+	RandomGenerator generator(dimension);
+	std::vector<uint64> boards;
+
+	for (size_t index = 0; index < count; index++) {
+		const uint64 presses = generator.Next() & Grid::FullMask(dimension);
+		uint64 board = 0;
+
+		for (int32 button = 0; button < dimension * dimension; button++) {
+			if ((presses >> button & 1) != 0)
+				board ^= Grid::PressMask(dimension, button);
+		}
+
+		boards.push_back(board);
+	}
+
+	return boards;
+}
+
+
+/*
+ * Check and time the solvers on boards, print a line for dimension, and
+ * return the number of boards they disagree on.
+ */
+
+static int32
+BenchmarkDimension(int8 dimension, const std::vector<uint64>& boards,
+	int32 rounds, uint64& checksum)
+{
+	const Solver& solver = Solver::ForDimension(dimension);
+	const ChaseSolver& chaseSolver = ChaseSolver::ForDimension(dimension);
+
+	int32 mismatches = 0;
+	for (size_t index = 0; index < boards.size(); index++)
+		if (solver.MinimumMoves(boards[index])
+				!= chaseSolver.MinimumMoves(boards[index]))
+			mismatches++;
+
+	SearchSolver searchSolver(dimension);
+	int32 searched = 0;
+
+	const std::chrono::steady_clock::time_point searchStart
+		= std::chrono::steady_clock::now();
+
+	for (size_t index = 0; index < boards.size(); index++) {
+		const int32 moves = solver.MinimumMoves(boards[index]);
+		if (moves > maxSearchMoves)
+			continue;
+
+		if (searchSolver.MinimumMoves(boards[index]) != moves)
+			mismatches++;
+		searched++;
+	}
+
+	const std::chrono::duration<double, std::milli> searchTime
+		= std::chrono::steady_clock::now() - searchStart;
+
+	const double eliminationTime = TimeSolver(solver, boards, rounds, checksum);
+	const double chaseTime = TimeSolver(chaseSolver, boards, rounds, checksum);
+
+	printf("%dx%d   %8.1f ns  %8.1f ns  %6.1fx  %8.2f ms (%d)\n",
+		(int) dimension, (int) dimension, eliminationTime, chaseTime,
+		eliminationTime / chaseTime,
+		searched > 0 ? searchTime.count() / searched : 0.0, (int) searched);
+
+	return mismatches;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const int32 rounds = argc > 1 ? atoi(argv[1]) : defaultRounds;
+
+	PuzzlePackSet packs;
+	std::vector<uint64> packBoards;
+
+	for (int32 pack = 0; pack < packs.CountPacks(); pack++) {
+		PuzzlePack* puzzles = packs.PackAt(pack);
+
+		for (uint32 level = 0; level < puzzles->Size(); level++)
+			packBoards.push_back(puzzles->ValueAt(level));
+	}
+
+	printf("%d boards per dimension, %d rounds; search on the boards of up "
+		"to %d moves,\ncounted in parentheses\n", (int) packBoards.size(),
+		(int) rounds, (int) maxSearchMoves);
+	printf("      elimination      chasing  speedup       search\n");
+
+	uint64 checksum = 0;
+	int32 mismatches = 0;
+
+	for (int8 dimension = minDimension; dimension <= maxDimension;
+			dimension++) {
+		mismatches += BenchmarkDimension(dimension, dimension == packDimension
+				? packBoards : RandomBoards(dimension, packBoards.size()),
+			rounds, checksum);
+	}
+
+	printf("mismatches %d\n", (int) mismatches);
+	printf("(checksum %llx)\n", (unsigned long long) checksum);
+
+	return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+/*
+ * Works out the optimal move count of every board of a dimension up to 5x5
+ * and prints how many boards there are at each difficulty.
+ *
+ * Usage: StateSpaceEnumerator [-t threads] [-o directory] [dimension...]
+ *	StateSpaceEnumerator -v database...
+ *	The default is to enumerate 3x3, 4x4 and 5x5. With -o, each table is
+ *	also written to directory/distances-NxN as a DistanceDatabase; -v checks
+ *	existing databases against their checksum and a fresh enumeration.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+
+#include "DistanceDatabase.h"
+#include "StateSpace.h"
+
+
+static int
+Enumerate(int8 dimension, int32 numThreads, const char* directory)
+{
+	const std::chrono::steady_clock::time_point start
+		= std::chrono::steady_clock::now();
+
+	const StateSpace space(dimension, numThreads);
+
+	const std::chrono::duration<double, std::milli> elapsed
+		= std::chrono::steady_clock::now() - start;
+
+	uint64 solvable = 0;
+	for (int32 moves = 0; moves <= space.MaxMoves(); moves++)
+		solvable += space.CountBoards(moves);
+
+	printf("%dx%d: %llu of %llu boards solvable, at most %d moves "
+		"(%.1f ms, %llu bytes)\n", dimension, dimension,
+		(unsigned long long) solvable,
+		(unsigned long long) 1 << (dimension * dimension), space.MaxMoves(),
+		elapsed.count(), (unsigned long long) space.DataSize());
+
+	for (int32 moves = 0; moves <= space.MaxMoves(); moves++)
+		printf("%6d %12llu\n", moves,
+			(unsigned long long) space.CountBoards(moves));
+
+	if (directory == NULL)
+		return 0;
+
+	const std::string path = DistanceDatabase::Path(directory, dimension);
+
+	status_t status = DistanceDatabase::Write(path.c_str(), space);
+	if (status != B_OK) {
+		fprintf(stderr, "%s: %s\n", path.c_str(),
+			strerror(B_TO_POSIX_ERROR(status)));
+		return 1;
+	}
+
+	return 0;
+}
+
+
+static int
+Verify(const char* path, int32 numThreads)
+{
+	DistanceDatabase database;
+
+	status_t status = database.Open(path);
+	if (status == B_OK)
+		status = database.Verify();
+	if (status != B_OK) {
+		fprintf(stderr, "%s: %s\n", path, strerror(B_TO_POSIX_ERROR(status)));
+		return 1;
+	}
+
+	const StateSpace space(database.Dimension(), numThreads);
+
+	for (uint64 board = 0; board < database.NumBoards(); board++) {
+		if (database.MinimumMoves(board) != space.MinimumMoves(board)) {
+			fprintf(stderr, "%s: board %llx takes %d moves, not %d\n", path,
+				(unsigned long long) board, space.MinimumMoves(board),
+				database.MinimumMoves(board));
+			return 1;
+		}
+	}
+
+	const BoardDistances& distances = database.Distances();
+	if (distances.MaxMoves() != space.MaxMoves()) {
+		fprintf(stderr, "%s: boards take up to %d moves, not %d\n", path,
+			space.MaxMoves(), distances.MaxMoves());
+		return 1;
+	}
+
+	for (int32 moves = 0; moves <= space.MaxMoves(); moves++) {
+		if (distances.CountBoards(moves) != space.CountBoards(moves)) {
+			fprintf(stderr, "%s: %llu boards take %d moves, not %llu\n", path,
+				(unsigned long long) space.CountBoards(moves), (int) moves,
+				(unsigned long long) distances.CountBoards(moves));
+			return 1;
+		}
+	}
+
+	printf("%s: %dx%d, %llu boards, ok\n", path, database.Dimension(),
+		database.Dimension(), (unsigned long long) database.NumBoards());
+	return 0;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 numThreads = 0;
+	const char* directory = NULL;
+	bool verify = false;
+
+	int option;
+	while ((option = getopt(argc, argv, "t:o:v")) != -1) {
+		switch (option) {
+			case 't':
+				numThreads = atoi(optarg);
+				break;
+			case 'o':
+				directory = optarg;
+				break;
+			case 'v':
+				verify = true;
+				break;
+			default:
+				fprintf(stderr, "usage: StateSpaceEnumerator [-t threads] "
+					"[-o directory] [dimension...]\n"
+					"       StateSpaceEnumerator -v database...\n");
+				return 2;
+		}
+	}
+
+	if (verify) {
+		int result = 0;
+		for (int arg = optind; arg < argc; arg++)
+			result |= Verify(argv[arg], numThreads);
+
+		return result;
+	}
+
+	if (optind == argc) {
+		for (int8 dimension = 3; dimension <= StateSpace::kMaxDimension;
+				dimension++) {
+			if (Enumerate(dimension, numThreads, directory) != 0)
+				return 1;
+		}
+
+		return 0;
+	}
+
+	for (int arg = optind; arg < argc; arg++) {
+		const int dimension = atoi(argv[arg]);
+
+		if (dimension < 1 || dimension > StateSpace::kMaxDimension) {
+			fprintf(stderr, "%s: only 1x1 through %dx%d can be enumerated\n",
+				argv[arg], StateSpace::kMaxDimension,
+				StateSpace::kMaxDimension);
+			return 1;
+		}
+
+		if (Enumerate(dimension, numThreads, directory) != 0)
+			return 1;
+	}
+
+	return 0;
+}